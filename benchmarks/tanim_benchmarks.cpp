@@ -0,0 +1,33 @@
+// times the curve and sampling core (see RunCurveBenchmarks) and writes the results as JSON and CSV, to compare commits.
+// built by CMakeLists.txt without ImGui's sources, a registry or a host.
+// usage: tanim_benchmarks [results.json] [results.csv]
+
+#include "tanim/include/benchmark.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static bool WriteFile(const std::string& path, const std::string& contents)
+{
+    std::ofstream file(path, std::ios::binary);
+    file << contents;
+    if (!file)
+    {
+        std::cerr << "couldn't write " << path << '\n';
+        return false;
+    }
+    std::cout << "wrote " << path << '\n';
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const std::string json_path = argc > 1 ? argv[1] : "tanim_benchmarks.json";
+    const std::string csv_path = argc > 2 ? argv[2] : "tanim_benchmarks.csv";
+
+    const tanim::BenchmarkReport report = tanim::RunCurveBenchmarks();
+    const bool json_written = WriteFile(json_path, tanim::BenchmarkReportToJson(report));
+    const bool csv_written = WriteFile(csv_path, tanim::BenchmarkReportToCsv(report));
+    return json_written && csv_written ? 0 : 1;
+}
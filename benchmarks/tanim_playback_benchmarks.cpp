@@ -0,0 +1,56 @@
+// plays the generated timeline of RunPlaybackBenchmark at a few scene sizes, saves and loads it as JSON and binary
+// (RunSerializationBenchmark), and writes the results as JSON and CSV, to compare commits.
+// built by CMakeLists.txt with all of tanim, so it stands in for the host functions of user_override.hpp.
+// usage: tanim_playback_benchmarks [output prefix], writes <prefix>_playback.json/.csv and <prefix>_serialization.json/.csv
+
+#include "tanim/include/benchmark.hpp"
+#include "tanim/include/timeline_data.hpp"
+#include "tanim/include/user_override.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// the benchmarks bind their entities directly, nothing is looked up by UID
+std::optional<entt::entity> tanim::FindEntityOfUID(const ComponentData&, const std::string&) { return std::nullopt; }
+
+void tanim::LogError(const std::string& message) { std::cerr << "error: " << message << '\n'; }
+
+void tanim::LogInfo(const std::string& message) { std::cout << message << '\n'; }
+
+static bool WriteFile(const std::string& path, const std::string& contents)
+{
+    std::ofstream file(path, std::ios::binary);
+    file << contents;
+    if (!file)
+    {
+        std::cerr << "couldn't write " << path << '\n';
+        return false;
+    }
+    std::cout << "wrote " << path << '\n';
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const std::string prefix = argc > 1 ? argv[1] : "tanim";
+
+    // 10x steps of the scene, at the default 7 sequences per entity
+    std::vector<tanim::PlaybackBenchmarkResult> playback{};
+    std::vector<tanim::SerializationBenchmarkResult> serialization{};
+    for (int entities : {10, 100, 1000})
+    {
+        tanim::PlaybackBenchmarkSettings settings{};
+        settings.m_entities = entities;
+        settings.m_sequences = entities * 7;
+        playback.push_back(tanim::RunPlaybackBenchmark(settings));
+        serialization.push_back(tanim::RunSerializationBenchmark(settings));
+    }
+
+    bool written = WriteFile(prefix + "_playback.json", tanim::PlaybackBenchmarkResultsToJson(playback));
+    written = WriteFile(prefix + "_playback.csv", tanim::PlaybackBenchmarkResultsToCsv(playback)) && written;
+    written = WriteFile(prefix + "_serialization.json", tanim::SerializationBenchmarkResultsToJson(serialization)) && written;
+    written = WriteFile(prefix + "_serialization.csv", tanim::SerializationBenchmarkResultsToCsv(serialization)) && written;
+    return written ? 0 : 1;
+}
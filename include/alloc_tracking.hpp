@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+namespace tanim
+{
+
+// === Allocation Tracking ===
+// define TANIM_TRACK_ALLOCATIONS for the whole build to count every heap allocation: tanim then replaces the global
+// operator new / delete (see alloc_tracking.cpp), so only define it in builds that don't replace them already.
+// allocations are counted per thread, so other threads allocating at the same time don't show up in a count.
+// the updates of Tanim record how many allocations they made (Tanim::GetLastUpdateAllocations), including those of the
+// tasks the parallel updates dispatched to other threads, and with Tanim::SetPlaybackAllocationGuard a playback update of
+// an already bound timeline that allocates logs an error and asserts.
+// without the define nothing is replaced and every count is 0
+
+#ifdef TANIM_TRACK_ALLOCATIONS
+inline constexpr bool kTrackAllocations = true;
+#else
+inline constexpr bool kTrackAllocations = false;
+#endif
+
+/// heap allocations made so far on the calling thread. always 0 without TANIM_TRACK_ALLOCATIONS
+int64_t GetAllocationCount();
+
+/// counts the heap allocations the calling thread made while it lives, e.g. around the updates of a test
+class AllocationScope
+{
+public:
+    AllocationScope() : m_start(GetAllocationCount()) {}
+
+    [[nodiscard]] int64_t GetCount() const { return GetAllocationCount() - m_start; }
+
+private:
+    int64_t m_start{0};
+};
+
+}  // namespace tanim
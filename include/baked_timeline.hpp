@@ -0,0 +1,160 @@
+#pragma once
+
+#include "tanim/include/timeline_data.hpp"
+#include "tanim/include/curve_quantize.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tanim
+{
+
+// === Baked Timeline File Records ===
+// written by Tanim::SerializeBaked, read in place by MappedTimeline. all values little-endian, all offsets from the file start
+
+struct BakedStringRef
+{
+    uint32_t m_offset;  // into the string blob
+    uint32_t m_length;
+};
+
+struct BakedHeader
+{
+    char m_magic[4];  // "TANR"
+    uint32_t m_version;
+    uint32_t m_file_size;
+    uint32_t m_strings_offset;
+    uint32_t m_strings_size;
+    uint32_t m_sequences_offset;
+    uint32_t m_sequence_count;
+    uint32_t m_curves_offset;
+    uint32_t m_curve_count;
+    BakedStringRef m_name;
+    int32_t m_first_frame;
+    int32_t m_last_frame;
+    int32_t m_min_frame;
+    int32_t m_max_frame;
+    uint32_t m_play_immediately;
+    int32_t m_player_samples;
+    uint32_t m_playback_type;
+};
+
+struct BakedSequenceRecord
+{
+    BakedStringRef m_uid;
+    BakedStringRef m_display;
+    BakedStringRef m_struct_name;
+    BakedStringRef m_field_name;
+    uint32_t m_type_meta;
+    uint32_t m_representation_meta;
+    int32_t m_first_frame;
+    int32_t m_last_frame;
+    uint32_t m_first_curve;  // index into the curve records
+    uint32_t m_curve_count;
+};
+
+enum class BakedCurveEncoding : uint8_t
+{
+    FLOAT,      // times, values and CompiledSegments, what RuntimeCurveView reads
+    QUANTIZED,  // QuantizedRange and QuantizedKeys, what QuantizedCurveView reads. see curve_quantize.hpp
+};
+
+struct BakedCurveRecord
+{
+    BakedStringRef m_name;
+    uint32_t m_keyframe_count;
+    uint32_t m_encoding;          // BakedCurveEncoding. the offsets of the other encoding are 0
+    uint32_t m_times_offset;      // float[m_keyframe_count]
+    uint32_t m_values_offset;     // float[m_keyframe_count]
+    uint32_t m_segments_offset;   // CompiledSegment[m_keyframe_count - 1]
+    uint32_t m_quantized_offset;  // QuantizedRange, then QuantizedKey[m_keyframe_count]
+};
+
+/// one sequence of a MappedTimeline. the strings point into the mapping
+struct MappedSequence
+{
+    std::string_view m_uid{};
+    std::string_view m_display{};
+    std::string_view m_struct_name{};
+    std::string_view m_field_name{};
+    Sequence::TypeMeta m_type_meta{Sequence::TypeMeta::NONE};
+    RepresentationMeta m_representation_meta{RepresentationMeta::NONE};
+    int m_first_frame{0};
+    int m_last_frame{0};
+    int m_curve_count{0};
+
+    bool IsBetweenFirstAndLastFrame(int frame_num) const { return frame_num >= m_first_frame && frame_num <= m_last_frame; }
+};
+
+/// read-only playback of a baked timeline file (see Tanim::SerializeBaked) straight from a memory mapping.
+/// curves are RuntimeCurveViews into the mapping, so opening costs page faults instead of allocations.
+/// play it with Tanim::StartTimeline(mapped.GetTimelineData(), ...) and Tanim::UpdateMappedTimeline
+class MappedTimeline
+{
+public:
+    MappedTimeline() = default;
+    ~MappedTimeline();
+
+    MappedTimeline(const MappedTimeline&) = delete;
+    MappedTimeline& operator=(const MappedTimeline&) = delete;
+    MappedTimeline(MappedTimeline&& other) noexcept;
+    MappedTimeline& operator=(MappedTimeline&& other) noexcept;
+
+    /// maps the file read-only. @return false if it can not be mapped or is not a valid baked timeline
+    bool Open(const std::string& path);
+
+    /// views bytes that are already in memory. they must stay alive and unchanged while this is open, and be 4-byte aligned
+    bool View(std::span<const uint8_t> bytes);
+
+    void Close();
+
+    bool IsOpen() const { return m_header != nullptr; }
+
+    /// the timeline settings (frames, samples, playback type) without sequences. used for ticking the player time
+    const TimelineData& GetTimelineData() const { return m_timeline_data; }
+
+    int GetSequenceCount() const { return IsOpen() ? static_cast<int>(m_header->m_sequence_count) : 0; }
+    MappedSequence GetSequence(int seq_idx) const;
+
+    /// whether the curve was baked with BakedCurveEncoding::QUANTIZED. read those with GetQuantizedCurve, others with GetCurve
+    bool IsCurveQuantized(int seq_idx, int curve_idx) const;
+    RuntimeCurveView GetCurve(int seq_idx, int curve_idx) const;
+    QuantizedCurveView GetQuantizedCurve(int seq_idx, int curve_idx) const;
+
+    /// stateless, safe to call from several threads
+    SampledValue Evaluate(int seq_idx, float sample_time) const;
+
+    /// times around sample_time over which Evaluate keeps giving its value at sample_time, see FindSequenceHold
+    HoldSpan FindHold(int seq_idx, float sample_time) const;
+
+    /// field index of each sequence in its component, filled by Tanim::BindMappedTimeline. -1 = unbound
+    std::vector<int>& GetFieldIndices() { return m_field_indices; }
+    const std::vector<int>& GetFieldIndices() const { return m_field_indices; }
+
+private:
+    std::span<const uint8_t> m_bytes{};
+    const BakedHeader* m_header{nullptr};
+    const BakedSequenceRecord* m_sequences{nullptr};
+    const BakedCurveRecord* m_curves{nullptr};
+
+    // OS mapping handles, only set when opened from a file
+    const void* m_mapping{nullptr};
+    size_t m_mapping_size{0};
+    void* m_file_handle{nullptr};
+    void* m_mapping_handle{nullptr};
+
+    TimelineData m_timeline_data{};
+    std::vector<int> m_field_indices{};
+    std::vector<QuatTrack> m_quat_tracks{};  // per sequence, compiled on open. empty for all but quaternion sequences
+
+    bool Validate() const;
+    void Adopt();
+    const BakedCurveRecord& GetCurveRecord(int seq_idx, int curve_idx) const;
+    std::string_view GetString(const BakedStringRef& ref) const;
+    void Unmap();
+};
+
+}  // namespace tanim
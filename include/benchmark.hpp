@@ -0,0 +1,139 @@
+#pragma once
+
+#include "tanim/include/keyframe.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace tanim
+{
+
+// === Micro-Benchmarks ===
+// times the curve and sampling core on generated curves, without an ImGui context or a registry. the tanim_benchmarks
+// target of CMakeLists.txt runs it without linking ImGui, to keep the results of every commit. for each keyframe count
+// and CurveHandleType:
+// - SampleCurveValue           random sample times, and forward playback with a cursor ("SampleCurveValue/cursor")
+// - FindSegmentIndex           random sample times on the runtime curve
+// - FindTForX                  random times in random segments
+// - SampleQuatForAnimation     a quaternion sequence whose W curve has the handle type, random sample times
+// - ResolveCurveHandles        the whole curve, one operation per call
+// - AddKeyframe                building the curve one keyframe at a time in time order, as recording does
+// results are ns per operation, written as JSON or CSV with BenchmarkReportToJson / BenchmarkReportToCsv
+
+/// settings of RunCurveBenchmarks
+struct BenchmarkSettings
+{
+    std::vector<int> m_keyframe_counts{2, 10, 100, 1000, 10000, 100000};
+    std::vector<CurveHandleType> m_handle_types{CurveHandleType::AUTO,
+                                                CurveHandleType::FLAT,
+                                                CurveHandleType::LINEAR,
+                                                CurveHandleType::CONSTANT};
+    int m_repetitions{5};            // timed runs per benchmark, the median and the fastest are reported
+    double m_min_run_seconds{0.02};  // each run repeats its batch of operations until at least this long
+    int m_samples{4096};             // sample times per batch of the sampling benchmarks
+    uint32_t m_seed{1};              // keyframe values and sample times are random, but the same for every run
+};
+
+/// one benchmark at one keyframe count and handle type
+struct BenchmarkResult
+{
+    std::string m_name{};
+    CurveHandleType m_handle_type{CurveHandleType::UNCONSTRAINED};
+    int m_keyframe_count{0};
+    int64_t m_operations{0};       // timed operations over all repetitions
+    double m_ns_per_op{0.0};       // median of the repetitions
+    double m_ns_per_op_best{0.0};  // fastest repetition
+};
+
+/// result of RunCurveBenchmarks
+struct BenchmarkReport
+{
+    std::vector<BenchmarkResult> m_results{};
+};
+
+/// runs every benchmark for every keyframe count and handle type of settings. takes seconds, not frames
+BenchmarkReport RunCurveBenchmarks(const BenchmarkSettings& settings = {});
+
+/// {"results": [{"name", "handle_type", "keyframes", "operations", "ns_per_op", "ns_per_op_best"}, ...]}
+std::string BenchmarkReportToJson(const BenchmarkReport& report);
+
+/// header row, then one row per result with the columns of BenchmarkReportToJson
+std::string BenchmarkReportToCsv(const BenchmarkReport& report);
+
+// === Playback Benchmark ===
+// plays a generated timeline on a generated scene with Tanim::StartTimeline / Tanim::UpdateTimeline, to see how a frame
+// scales with the entity and sequence counts. the scene is its own entt::registry of m_entities entities, each with a
+// component holding a float, int, bool, vec2, vec3, vec4 and quat field. sequence s animates field s / m_entities of
+// entity s % m_entities, so m_sequences is at most 7 * m_entities. the component is registered in a Registry of the
+// benchmark's own, not in GetRegistry(), and entities are bound directly instead of through FindEntityOfUID.
+// implemented in playback_benchmark.cpp, which needs all of tanim
+
+/// settings of RunPlaybackBenchmark
+struct PlaybackBenchmarkSettings
+{
+    int m_entities{100};
+    int m_sequences{700};
+    int m_keyframes{8};          // per curve, spread evenly over the timeline
+    int m_last_frame{300};
+    int m_warmup_ticks{60};      // updates before the timed ones, e.g. to get past the first writes of static sequences
+    int m_ticks{600};            // timed updates
+    float m_delta_time{1.0f / 60.0f};
+    uint32_t m_seed{1};
+
+    // heap allocations made so far, e.g. counted by the host's operator new. defaults to GetAllocationCount with
+    // TANIM_TRACK_ALLOCATIONS (see alloc_tracking.hpp), otherwise allocations aren't reported
+    std::function<int64_t()> m_allocation_counter{};
+};
+
+/// result of one RunPlaybackBenchmark
+struct PlaybackBenchmarkResult
+{
+    int m_entities{0};
+    int m_sequences{0};
+    int m_ticks{0};
+    double m_ns_per_tick{0.0};
+    double m_ns_per_sequence_tick{0.0};
+    double m_allocations_per_tick{-1.0};  // -1 without an allocation counter, see PlaybackBenchmarkSettings
+};
+
+/// builds the scene and timeline of settings and times its updates. e.g. run it for 10x the entities or sequences
+PlaybackBenchmarkResult RunPlaybackBenchmark(const PlaybackBenchmarkSettings& settings = {});
+
+/// {"playback": [{"entities", "sequences", "ticks", "ns_per_tick", "ns_per_sequence_tick", "allocations_per_tick"}, ...]}
+std::string PlaybackBenchmarkResultsToJson(std::span<const PlaybackBenchmarkResult> results);
+
+/// header row, then one row per result with the columns of PlaybackBenchmarkResultsToJson
+std::string PlaybackBenchmarkResultsToCsv(std::span<const PlaybackBenchmarkResult> results);
+
+// === Serialization Benchmark ===
+// saves and loads the generated timeline of RunPlaybackBenchmark with Tanim::Serialize / Tanim::Deserialize (JSON) and
+// Tanim::SerializeBinary / Tanim::DeserializeBinary, to compare the size and load time of the two formats
+
+/// result of one RunSerializationBenchmark. times are the median of its repetitions, in milliseconds
+struct SerializationBenchmarkResult
+{
+    int m_sequences{0};
+    int m_keyframes{0};  // per curve
+    int64_t m_json_bytes{0};
+    double m_json_save_ms{0.0};
+    double m_json_load_ms{0.0};
+    int64_t m_binary_bytes{0};
+    double m_binary_save_ms{0.0};
+    double m_binary_load_ms{0.0};  // -1 if DeserializeBinary rejected the bytes
+};
+
+/// builds the timeline of settings (its scene is only used to create the sequences), then saves and loads it in both
+/// formats repetitions times each. the warmup, tick and allocation settings are unused
+SerializationBenchmarkResult RunSerializationBenchmark(const PlaybackBenchmarkSettings& settings = {}, int repetitions = 10);
+
+/// {"serialization": [{"sequences", "keyframes", "json_bytes", "json_save_ms", "json_load_ms", "binary_bytes",
+///                     "binary_save_ms", "binary_load_ms"}, ...]}
+std::string SerializationBenchmarkResultsToJson(std::span<const SerializationBenchmarkResult> results);
+
+/// header row, then one row per result with the columns of SerializationBenchmarkResultsToJson
+std::string SerializationBenchmarkResultsToCsv(std::span<const SerializationBenchmarkResult> results);
+
+}  // namespace tanim
@@ -23,29 +23,101 @@ float CubicBezierDxDt(float p0x, float p1x, float p2x, float p3x, float t);
 // === Curve Sampling (reads pre-computed m_dir and m_weight directly) ===
 
 // Sample curve for animation playback (returns Y value at given time/frame)
-// Handles CONSTANT segments appropriately
+// Handles CONSTANT segments appropriately. Reads only curve.m_runtime, never the keyframes.
 float SampleCurveValue(const Curve& curve, float time);
 
+// Same as above, using (and updating) a playback cursor to find the segment. See FindSegmentIndex.
+float SampleCurveValue(const Curve& curve, float time, int& cursor);
+
+// Sample a runtime curve (returns Y value at given time/frame)
+float SampleRuntimeCurve(const RuntimeCurveView& runtime, float time);
+float SampleRuntimeCurve(const RuntimeCurveView& runtime, float time, int& cursor);
+
+// Evaluate segment seg of a runtime curve at the given time/frame (time must lie inside the segment)
+float SampleRuntimeSegment(const RuntimeCurveView& runtime, int seg, float time);
+
+// Sample the uniform-time table of a runtime curve: one index and a lerp. SampleRuntimeCurve uses it when it is baked.
+float SampleRuntimeLut(const RuntimeCurveView& runtime, float time);
+
+// Times around time over which SampleRuntimeCurve keeps returning its value at time: before the first and after the
+// last keyframe, CONSTANT segments, and segments between two equal keyframes with level handles.
+// Empty when the value changes at time. Curves with a table (see BakeCurveLut) only hold outside of it.
+HoldSpan FindRuntimeHold(const RuntimeCurveView& runtime, float time);
+
+// Same as above, using (and updating) a playback cursor to find the segment. See FindSegmentIndex.
+HoldSpan FindRuntimeHold(const RuntimeCurveView& runtime, float time, int& cursor);
+
 // Sample curve for drawing (returns normalized position for UI rendering)
 // t: normalized parameter across entire curve [0, 1]
 // min, max: view bounds for normalization
 ImVec2 SampleCurveForDrawing(const Curve& curve, float t, const ImVec2& min, const ImVec2& max);
 
-// Find which segment contains the given time
+// Find which segment contains the given time (binary search)
 // Returns the index of the keyframe at the start of the segment, or -1 if before first keyframe
 int FindSegmentIndex(const Curve& curve, float time);
 
+// Same as above, on the keyframe times of a runtime curve
+int FindSegmentIndex(const RuntimeCurveView& runtime, float time);
+
+// Same as above, starting from the segment found by the previous call.
+// cursor: per-curve playback state, checked first together with the segment after it (O(1) for forward playback).
+// Falls back to the binary search on seeks and backward jumps, and stores the found segment back in cursor.
+int FindSegmentIndex(const RuntimeCurveView& runtime, float time, int& cursor);
+
 // Find parameter t for a given X value using Newton-Raphson iteration.
 // p0, p1, p2, p3: Bezier control points
 // target_x: the X value to find
 float FindTForX(float p0x, float p1x, float p2x, float p3x, float target_x);
 
+// Find parameter t for a given X value of a compiled segment using Newton-Raphson iteration.
+float FindTForX(const CompiledSegment& segment, float start_x, float end_x, float target_x);
+
+// Find parameter t for a given X value of a compiled segment with a closed-form cubic solve
+// (Cardano for one real root, the trigonometric form for three). No iterations, so no stalls where dx/dt is near 0.
+float SolveTForXAnalytic(const CompiledSegment& segment, float target_x);
+
+// How far SolveTForXAnalytic is from the Newton-Raphson FindTForX, see MeasureTimeSolverAccuracy
+struct TimeSolverAccuracy
+{
+    int m_samples{0};
+    float m_max_t_difference{0.0f};
+    float m_max_value_difference{0.0f};
+    float m_mean_value_difference{0.0f};
+    float m_max_newton_residual{0.0f};    // largest |x(t) - target_x| of the Newton-Raphson t
+    float m_max_analytic_residual{0.0f};  // largest |x(t) - target_x| of the analytic t
+};
+
+// Solve both ways at samples_per_segment evenly spaced times inside every Bezier segment of the curve and compare.
+TimeSolverAccuracy MeasureTimeSolverAccuracy(const RuntimeCurveView& runtime, int samples_per_segment);
+
+// === Runtime Curve Baking (called by ResolveCurveHandles) ===
+
+// Convert one segment's Bezier control points to power-basis coefficients.
+CompiledSegment CompileSegment(const Keyframe& k0, const Keyframe& k1);
+
+// Build the runtime form of a curve from its keyframes and their resolved handles.
+RuntimeCurve BakeRuntimeCurve(const Curve& curve);
+void BakeRuntimeCurve(const Curve& curve, RuntimeCurve& runtime);
+
+// Rebuild curve.m_runtime.
+void CompileCurve(Curve& curve);
+
+// Keep curve.m_runtime the size of the keyframes after one was inserted at, or erased from, keyframe_index.
+// The runtime entries around it are stale until ResolveKeyframeRange recompiles them.
+void InsertRuntimeKeyframe(RuntimeCurve& runtime, int keyframe_index);
+void EraseRuntimeKeyframe(RuntimeCurve& runtime, int keyframe_index);
+
 // === Handle Resolution (call after any keyframe/handle modification) ===
 
-// Resolve all handle m_dir and m_weight values in the curve.
+// Resolve all handle m_dir and m_weight values in the curve, then recompile it.
 // Call this after any modification to keyframes or handle settings.
 void ResolveCurveHandles(Curve& curve);
 
+// Resolve only the keyframes an edit of keyframes [first, last] can affect, and recompile only their segments.
+// AUTO and LINEAR handles depend on the neighbour positions, so keyframes first - 1 to last + 1 are resolved.
+// O(last - first) instead of O(n). Falls back to ResolveCurveHandles when curve.m_runtime is not the size of the keyframes.
+void ResolveKeyframeRange(Curve& curve, int first, int last);
+
 // Resolve handles for a single keyframe.
 // prev_key, next_key can be nullptr for first/last keyframes.
 void ResolveKeyframeHandles(Keyframe& keyframe, const Keyframe* prev_key, const Keyframe* next_key);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "tanim/include/keyframe.hpp"
+
+#include <span>
+
+namespace tanim
+{
+
+// === Batch Bezier Evaluation ===
+// Evaluates many curves or many times per call, using AVX2 (8 lanes) or SSE2 (4 lanes) when the compiler targets them,
+// and the scalar functions of bezier.hpp otherwise. Define TANIM_NO_SIMD to force the scalar path.
+//
+// Every lane does exactly the operations of the matching scalar function, in the same order, so results are
+// bit-identical to it as long as the compiler does not contract mul+add into FMA (GCC/Clang: -ffp-contract=off,
+// the default with -std=c++20. MSVC: the default /fp:precise).
+//
+// Three shapes per function, out.size() is the batch size and all input spans must be at least that long:
+// - per lane:               out[i] = f(p0[i], p1[i], p2[i], p3[i], t[i])
+// - N curves at one time:   out[i] = f(p0[i], p1[i], p2[i], p3[i], t)
+// - one curve at N times:   out[i] = f(p0, p1, p2, p3, t[i])
+
+// Lanes per SIMD step the batch functions were compiled for: 8 (AVX2), 4 (SSE2) or 1 (scalar)
+int GetBezierBatchWidth();
+
+// Batch CubicBezierX / CubicBezierY (both evaluate the same polynomial)
+void CubicBezierBatch(std::span<const float> p0,
+                      std::span<const float> p1,
+                      std::span<const float> p2,
+                      std::span<const float> p3,
+                      std::span<const float> t,
+                      std::span<float> out);
+void CubicBezierBatch(std::span<const float> p0,
+                      std::span<const float> p1,
+                      std::span<const float> p2,
+                      std::span<const float> p3,
+                      float t,
+                      std::span<float> out);
+void CubicBezierBatch(float p0, float p1, float p2, float p3, std::span<const float> t, std::span<float> out);
+
+// Batch CubicBezierDxDt
+void CubicBezierDxDtBatch(std::span<const float> p0,
+                          std::span<const float> p1,
+                          std::span<const float> p2,
+                          std::span<const float> p3,
+                          std::span<const float> t,
+                          std::span<float> out);
+void CubicBezierDxDtBatch(std::span<const float> p0,
+                          std::span<const float> p1,
+                          std::span<const float> p2,
+                          std::span<const float> p3,
+                          float t,
+                          std::span<float> out);
+void CubicBezierDxDtBatch(float p0, float p1, float p2, float p3, std::span<const float> t, std::span<float> out);
+
+// Batch FindTForX. Newton-Raphson runs on all lanes together, a lane stops updating once it converged,
+// and the batch stops once every lane did (or after the same 8 iterations as the scalar version).
+void FindTForXBatch(std::span<const float> p0x,
+                    std::span<const float> p1x,
+                    std::span<const float> p2x,
+                    std::span<const float> p3x,
+                    std::span<const float> target_x,
+                    std::span<float> out_t);
+void FindTForXBatch(std::span<const float> p0x,
+                    std::span<const float> p1x,
+                    std::span<const float> p2x,
+                    std::span<const float> p3x,
+                    float target_x,
+                    std::span<float> out_t);
+void FindTForXBatch(float p0x, float p1x, float p2x, float p3x, std::span<const float> target_x, std::span<float> out_t);
+
+// Batch SampleRuntimeCurve: one runtime curve at N times, out.size() == times.size().
+// Segments are found per time (fastest with ascending times), then the Newton solves of all times run in lanes.
+// Segments of curves with TimeSolver::ANALYTIC are solved one time at a time with SolveTForXAnalytic.
+void SampleRuntimeCurveBatch(const RuntimeCurveView& runtime, std::span<const float> times, std::span<float> out);
+
+}  // namespace tanim
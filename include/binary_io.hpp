@@ -0,0 +1,148 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace tanim
+{
+
+/// appends little-endian values to a byte buffer, independent of the host byte order
+class BinaryWriter
+{
+public:
+    void WriteU8(uint8_t value) { m_bytes.push_back(value); }
+
+    void WriteU16(uint16_t value)
+    {
+        m_bytes.push_back(static_cast<uint8_t>(value));
+        m_bytes.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void WriteU32(uint32_t value)
+    {
+        for (int byte = 0; byte < 4; ++byte) m_bytes.push_back(static_cast<uint8_t>(value >> (byte * 8)));
+    }
+
+    void WriteI32(int32_t value) { WriteU32(static_cast<uint32_t>(value)); }
+
+    void WriteF32(float value) { WriteU32(std::bit_cast<uint32_t>(value)); }
+
+    void WriteBool(bool value) { WriteU8(value ? 1 : 0); }
+
+    template <typename EnumType>
+    void WriteEnum(EnumType value)
+    {
+        static_assert(sizeof(EnumType) == 1, "enums are stored as one byte");
+        WriteU8(static_cast<uint8_t>(value));
+    }
+
+    void WriteBytes(std::string_view bytes) { m_bytes.insert(m_bytes.end(), bytes.begin(), bytes.end()); }
+
+    /// overwrites 4 bytes that were written before, e.g. a size that is only known later
+    void PatchU32(size_t offset, uint32_t value)
+    {
+        for (int byte = 0; byte < 4; ++byte) m_bytes.at(offset + byte) = static_cast<uint8_t>(value >> (byte * 8));
+    }
+
+    void AlignTo(size_t alignment)
+    {
+        while (m_bytes.size() % alignment != 0) m_bytes.push_back(0);
+    }
+
+    size_t GetSize() const { return m_bytes.size(); }
+    std::vector<uint8_t>& GetBytes() { return m_bytes; }
+
+private:
+    std::vector<uint8_t> m_bytes{};
+};
+
+/// reads little-endian values from a byte span. reading past the end returns zeros and sets the failed flag
+class BinaryReader
+{
+public:
+    explicit BinaryReader(std::span<const uint8_t> bytes) : m_bytes(bytes) {}
+
+    uint8_t ReadU8()
+    {
+        if (!CanRead(1)) return 0;
+        return m_bytes[m_offset++];
+    }
+
+    uint32_t ReadU32()
+    {
+        if (!CanRead(4)) return 0;
+        uint32_t value = 0;
+        for (int byte = 0; byte < 4; ++byte) value |= static_cast<uint32_t>(m_bytes[m_offset++]) << (byte * 8);
+        return value;
+    }
+
+    int32_t ReadI32() { return static_cast<int32_t>(ReadU32()); }
+
+    float ReadF32() { return std::bit_cast<float>(ReadU32()); }
+
+    bool ReadBool() { return ReadU8() != 0; }
+
+    std::string_view ReadBytes(size_t count)
+    {
+        if (!CanRead(count)) return {};
+        const std::string_view bytes(reinterpret_cast<const char*>(m_bytes.data()) + m_offset, count);
+        m_offset += count;
+        return bytes;
+    }
+
+    void Skip(size_t count)
+    {
+        if (CanRead(count)) m_offset += count;
+    }
+
+    void AlignTo(size_t alignment) { Skip((alignment - m_offset % alignment) % alignment); }
+
+    /// marks the data as invalid, e.g. when a value is out of range
+    void Fail() { m_failed = true; }
+
+    bool HasFailed() const { return m_failed; }
+    size_t GetOffset() const { return m_offset; }
+    size_t GetRemaining() const { return m_bytes.size() - m_offset; }
+
+private:
+    std::span<const uint8_t> m_bytes{};
+    size_t m_offset{0};
+    bool m_failed{false};
+
+    bool CanRead(size_t count)
+    {
+        if (m_failed || count > m_bytes.size() - m_offset)
+        {
+            m_failed = true;
+            return false;
+        }
+        return true;
+    }
+};
+
+/// deduplicates strings into an indexed table, so repeated uids and field names are stored once
+class StringTable
+{
+public:
+    uint32_t Intern(const std::string& str)
+    {
+        const auto [it, inserted] = m_indices.try_emplace(str, static_cast<uint32_t>(m_strings.size()));
+        if (inserted) m_strings.push_back(str);
+        return it->second;
+    }
+
+    const std::vector<std::string>& GetStrings() const { return m_strings; }
+
+private:
+    std::vector<std::string> m_strings{};
+    std::unordered_map<std::string, uint32_t> m_indices{};
+};
+
+}  // namespace tanim
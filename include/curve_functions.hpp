@@ -2,6 +2,9 @@
 
 #include "tanim/include/keyframe.hpp"
 
+#include <span>
+#include <utility>
+
 namespace tanim
 {
 
@@ -23,6 +26,11 @@ void ApplyCurveHandleTypeOnCurve(Curve& curve);
 // Returns the index of the new keyframe, or -1 if a keyframe already exists at that time.
 int AddKeyframe(Curve& curve, float time, float value);
 
+// Add many keyframes at once: sorts and dedupes them once and resolves the curve once, O((n + m) log m).
+// keys are (time, value) pairs in any order. Times that already have a keyframe, or appear twice, keep the first one.
+// The locked CurveHandleType is applied to every new keyframe. Returns the number of keyframes added.
+int AddKeyframes(Curve& curve, std::span<const std::pair<float, float>> keys);
+
 // Remove a keyframe by index. Cannot remove first or last keyframe.
 // Returns true if removed, false if index invalid or is first/last.
 bool RemoveKeyframe(Curve& curve, int keyframe_index);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "tanim/include/keyframe.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace tanim
+{
+
+// === Uniform-Time Lookup Tables ===
+// a curve can be resampled into a dense table of values at a fixed step. SampleRuntimeCurve then costs one index and a lerp,
+// independent of the keyframe count and the shape of the segments. editing the curve (CompileCurve) drops the table.
+
+/// settings of Tanim::BakeTimelineLuts
+struct LutBakeSettings
+{
+    int m_oversample{1};                  // table entries per frame. 1 = the timeline's m_player_samples rate
+    size_t m_memory_budget{256 * 1024};   // bytes of tables the whole timeline may use
+    float m_max_error{-1.0f};             // curves whose table is off by more than this stay analytic. negative = no limit
+};
+
+/// how far the table of one curve is from the analytic SampleRuntimeCurve result
+struct CurveLutReport
+{
+    int m_seq_idx{-1};
+    int m_curve_idx{-1};
+    int m_entries{0};
+    size_t m_bytes{0};
+    float m_max_error{0.0f};
+    float m_mean_error{0.0f};
+    bool m_baked{false};  // false if it did not fit the budget or exceeded m_max_error
+};
+
+/// result of Tanim::BakeTimelineLuts
+struct LutBakeReport
+{
+    size_t m_bytes_used{0};
+    size_t m_bytes_wanted{0};  // what tables for every candidate curve would take
+    int m_curves_baked{0};
+    int m_curves_skipped{0};
+    float m_max_error{0.0f};  // over the baked curves
+    std::vector<CurveLutReport> m_curves{};
+};
+
+/// builds the table of curve, with step frames between entries, covering its first to its last keyframe.
+/// @return the number of entries. 0 if the curve has less than two keyframes, such curves are O(1) already
+int BakeCurveLut(Curve& curve, float step);
+
+void ClearCurveLut(Curve& curve);
+
+/// compares the table of curve with the analytic result at a quarter, half and three quarters of every step.
+/// the table must be baked
+CurveLutReport MeasureCurveLutError(const Curve& curve);
+
+}  // namespace tanim
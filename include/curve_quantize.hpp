@@ -0,0 +1,112 @@
+#pragma once
+
+#include "tanim/include/keyframe.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace tanim
+{
+
+// === Quantized Curves ===
+// compact playback form of a runtime curve for shipped timelines (see Tanim::SerializeBaked): 16 bytes per keyframe
+// instead of 44. times are whole frames, values and handle offsets are 16-bit steps of a per-curve range.
+// sampling decodes the two keyframes of a segment and evaluates it exactly like SampleRuntimeSegment
+
+/// CompiledSegment flags of the segment starting at a QuantizedKey
+enum QuantizedKeyFlags : uint8_t
+{
+    kQuantizedConstant = 1 << 0,
+    kQuantizedFlat = 1 << 1,
+    kQuantizedAnalytic = 1 << 2,
+    kQuantizedLevel = 1 << 3,
+};
+
+struct QuantizedKey
+{
+    int32_t m_frame;
+    uint16_t m_value;   // m_value_min + m_value * m_value_step
+    uint16_t m_in_x;    // in-handle length as a fraction of the segment before, 0xFFFF = the whole segment
+    uint16_t m_in_y;    // m_offset_min + m_in_y * m_offset_step
+    uint16_t m_out_x;   // out-handle length as a fraction of the segment after
+    uint16_t m_out_y;
+    uint8_t m_flags;    // QuantizedKeyFlags
+    uint8_t m_padding;
+};
+
+/// per-curve ranges the 16-bit values are steps of
+struct QuantizedRange
+{
+    float m_value_min{0.0f};
+    float m_value_step{0.0f};
+    float m_offset_min{0.0f};  // handle y offsets
+    float m_offset_step{0.0f};
+};
+
+struct QuantizedCurve
+{
+    QuantizedRange m_range{};
+    std::vector<QuantizedKey> m_keys{};
+};
+
+/// non-owning view of a QuantizedCurve, or of one in a baked timeline mapped from disk
+struct QuantizedCurveView
+{
+    QuantizedRange m_range{};
+    std::span<const QuantizedKey> m_keys{};
+
+    QuantizedCurveView() = default;
+
+    QuantizedCurveView(const QuantizedRange& range, std::span<const QuantizedKey> keys) : m_range(range), m_keys(keys) {}
+
+    // implicit, so a QuantizedCurve can be passed wherever a view is expected
+    QuantizedCurveView(const QuantizedCurve& curve) : m_range(curve.m_range), m_keys(curve.m_keys) {}
+};
+
+/// settings of the quantization in Tanim::SerializeBaked
+struct QuantizeSettings
+{
+    bool m_enabled{false};
+    float m_max_error{1e-3f};      // curves whose quantized form is off by more than this stay float
+    int m_samples_per_segment{8};  // the error is measured at this many times in every segment
+};
+
+/// how one curve was stored by Tanim::SerializeBaked
+struct CurveQuantizeReport
+{
+    int m_seq_idx{-1};
+    int m_curve_idx{-1};
+    bool m_quantized{false};  // false if it has keyframes off whole frames, is part of a quaternion or exceeded m_max_error
+    float m_max_error{0.0f};
+};
+
+/// result of Tanim::SerializeBaked with quantization
+struct QuantizeReport
+{
+    int m_curves_quantized{0};
+    int m_curves_float{0};
+    size_t m_bytes_saved{0};  // compared to storing every curve as float
+    float m_max_error{0.0f};  // over the quantized curves
+    std::vector<CurveQuantizeReport> m_curves{};
+};
+
+/// whether every keyframe of runtime is on a whole frame, which the quantized form needs
+bool CanQuantizeCurve(const RuntimeCurveView& runtime);
+
+/// the quantized form of runtime. CanQuantizeCurve must be true
+QuantizedCurve QuantizeCurve(const RuntimeCurve& runtime);
+
+/// max difference between the quantized and the float curve, at samples_per_segment times in every segment
+float MeasureQuantizeError(const QuantizedCurveView& quantized, const RuntimeCurveView& runtime, int samples_per_segment);
+
+// Sample a quantized curve (returns Y value at given time/frame), same results as SampleRuntimeCurve up to the quantization
+float SampleQuantizedCurve(const QuantizedCurveView& curve, float time);
+
+// Same as above, using (and updating) a playback cursor to find the segment. See FindSegmentIndex.
+float SampleQuantizedCurve(const QuantizedCurveView& curve, float time, int& cursor);
+
+// FindRuntimeHold of a quantized curve: times around time over which SampleQuantizedCurve returns its value at time
+HoldSpan FindQuantizedHold(const QuantizedCurveView& curve, float time);
+
+}  // namespace tanim
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "tanim/include/keyframe.hpp"
+#include "tanim/include/sequence.hpp"
+
+#include <vector>
+
+namespace tanim
+{
+
+// === Keyframe Reduction ===
+// removes keyframes (e.g. of a recording, one per frame) while the sampled curve stays within a tolerance of the original.
+// the first and last keyframes are always kept.
+// - unlocked curves: runs of keyframes are replaced by one segment whose FREE handles keep the original tangents at both
+//   ends, with the handle lengths fitted (weighted handles) when the default lengths are not close enough.
+//   CONSTANT segments are kept as they are
+// - locked curves keep their CurveHandleType: a keyframe is only removed if the resolved curve without it is close enough
+// - INT and BOOL sequences are compared on the field value (floored / thresholded) and must match exactly
+// - quaternion sequences remove a keyframe from all their curves at once, if slerping over it stays within
+//   m_quat_tolerance. keyframes next to spins, CONSTANT or FLAT segments are kept
+
+/// settings of ReduceCurve, ReduceSequence and Tanim::ReduceTimeline
+struct ReduceSettings
+{
+    float m_tolerance{1e-3f};        // max value error of the reduced curve
+    float m_quat_tolerance{1e-3f};   // max rotation error of quaternion sequences, in radians
+    int m_samples_per_segment{8};    // the error is measured at this many times in every original segment
+};
+
+/// result of reducing one curve
+struct CurveReduceReport
+{
+    int m_seq_idx{-1};
+    int m_curve_idx{-1};
+    int m_keyframes_before{0};
+    int m_keyframes_after{0};
+    float m_compression_ratio{1.0f};  // m_keyframes_before / m_keyframes_after
+    float m_max_error{0.0f};          // measured on the reduced curve. radians for quaternion sequences
+};
+
+/// result of Tanim::ReduceTimeline
+struct ReduceReport
+{
+    int m_keyframes_before{0};
+    int m_keyframes_after{0};
+    float m_compression_ratio{1.0f};
+    float m_max_error{0.0f};  // over the non-quaternion curves
+    float m_max_quat_error{0.0f};
+    std::vector<CurveReduceReport> m_curves{};
+};
+
+/// reduces the keyframes of one curve. type_meta is the TypeMeta of the sequence the curve belongs to
+CurveReduceReport ReduceCurve(Curve& curve,
+                              const ReduceSettings& settings,
+                              Sequence::TypeMeta type_meta = Sequence::TypeMeta::NONE);
+
+/// reduces every curve of seq, quaternion sequences as a whole. one report per curve, m_seq_idx is left at -1
+std::vector<CurveReduceReport> ReduceSequence(Sequence& seq, const ReduceSettings& settings);
+
+}  // namespace tanim
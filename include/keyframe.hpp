@@ -2,6 +2,8 @@
 
 #include "tanim/include/includes.hpp"
 
+#include <array>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -25,6 +27,20 @@ enum class CurveHandleType : uint8_t
     CONSTANT,  // Broken
 };
 
+// How playback finds the Bezier parameter t of a sample time, see SampleRuntimeSegment
+enum class TimeSolver : uint8_t
+{
+    NEWTON,    // FindTForX: up to 8 Newton-Raphson iterations, stops early once converged
+    ANALYTIC,  // SolveTForXAnalytic: closed-form cubic root, same cost for every sample
+};
+
+// Define TANIM_ANALYTIC_TIME_SOLVE to make ANALYTIC the default of every new Curve
+#ifdef TANIM_ANALYTIC_TIME_SOLVE
+inline constexpr TimeSolver kDefaultTimeSolver = TimeSolver::ANALYTIC;
+#else
+inline constexpr TimeSolver kDefaultTimeSolver = TimeSolver::NEWTON;
+#endif
+
 struct Handle
 {
     enum class SmoothType : uint8_t
@@ -83,10 +99,82 @@ struct Keyframe
     int Frame() const { return static_cast<int>(m_pos.x); }
 };
 
+// One Bezier segment converted to power basis: f(t) = ((c[0] * t + c[1]) * t + c[2]) * t + c[3], t in [0, 1]
+struct CompiledSegment
+{
+    std::array<float, 4> m_x{};  // time coefficients
+    std::array<float, 4> m_y{};  // value coefficients
+    bool m_constant{false};      // CONSTANT out-handle: holds the start value until the next keyframe
+    bool m_flat{false};          // FLAT out-handle: quaternion tracks ease this segment with smoothstep
+    bool m_analytic{false};      // find t with SolveTForXAnalytic instead of FindTForX (Curve::m_time_solver)
+    bool m_level{false};         // equal keyframes with level handles: holds the start value, sampled without Bezier math
+};
+
+// Compact, resolve-free playback form of a Curve: handles already resolved, no editor state, strings or enums.
+// Produced by BakeRuntimeCurve(). Every Curve keeps its own copy in m_runtime, rebuilt whenever the curve is edited.
+struct RuntimeCurve
+{
+    std::vector<float> m_times{};               // keyframe times
+    std::vector<float> m_values{};              // keyframe values
+    std::vector<ImVec2> m_in_tangents{};        // resolved in-handle offsets
+    std::vector<ImVec2> m_out_tangents{};       // resolved out-handle offsets
+    std::vector<CompiledSegment> m_segments{};  // one fewer than keyframes
+
+    // optional uniform-time table, see BakeCurveLut. m_lut_values[i] is the value at m_lut_start + i / m_lut_inv_step
+    std::vector<float> m_lut_values{};
+    float m_lut_start{0.0f};
+    float m_lut_inv_step{0.0f};
+
+    uint32_t m_revision{0};  // a new, process-wide unique value whenever the keyframe data changes. see QuatTrack
+};
+
+// Non-owning view of playback data: a RuntimeCurve, or a baked timeline mapped from disk (see MappedTimeline).
+// All playback sampling (SampleRuntimeCurve, FindSegmentIndex) works on views.
+struct RuntimeCurveView
+{
+    std::span<const float> m_times{};
+    std::span<const float> m_values{};
+    std::span<const CompiledSegment> m_segments{};
+    std::span<const float> m_lut_values{};  // empty when the curve has no table
+    float m_lut_start{0.0f};
+    float m_lut_inv_step{0.0f};
+
+    RuntimeCurveView() = default;
+
+    RuntimeCurveView(std::span<const float> times, std::span<const float> values, std::span<const CompiledSegment> segments)
+        : m_times(times), m_values(values), m_segments(segments)
+    {
+    }
+
+    // implicit, so a RuntimeCurve can be passed wherever a view is expected
+    RuntimeCurveView(const RuntimeCurve& runtime)
+        : m_times(runtime.m_times),
+          m_values(runtime.m_values),
+          m_segments(runtime.m_segments),
+          m_lut_values(runtime.m_lut_values),
+          m_lut_start(runtime.m_lut_start),
+          m_lut_inv_step(runtime.m_lut_inv_step)
+    {
+    }
+};
+
+// Times (m_begin, m_end] over which a sampled value stays what it was, see FindRuntimeHold. Empty by default.
+// Playback skips sampling and writing a sequence while its sample time stays inside the hold of its last write.
+struct HoldSpan
+{
+    float m_begin{0.0f};
+    float m_end{0.0f};
+
+    [[nodiscard]] bool Contains(float time) const { return time > m_begin && time <= m_end; }
+};
+
 struct Curve
 {
     std::vector<Keyframe> m_keyframes{};
+    RuntimeCurve m_runtime{};
+    int m_playback_cursor{0};  // segment of the last playback sample, see FindSegmentIndex
     CurveHandleType m_curve_handle_type{CurveHandleType::UNCONSTRAINED};
+    TimeSolver m_time_solver{kDefaultTimeSolver};  // not serialized. takes effect on the next CompileCurve
     bool m_handle_type_locked{false};
     bool m_visibility{true};
     std::string m_name{"new_curve"};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tanim
+{
+
+struct TimelineData;
+
+// === Profiling ===
+// define TANIM_PROFILING for the whole build to time tanim's scopes (TANIM_PROFILE_SCOPE) and count the work of every
+// timeline update (TANIM_PROFILE_TIMELINE). the results are read through Profiler and shown in the "Profiler" window of
+// Tanim::Draw. without the define the macros compile to nothing and every stat stays 0
+
+/// timed scopes, see Profiler::GetScopeStats
+enum class ProfileScope : uint8_t
+{
+    TICK_TIME,       // Timeline::TickTime
+    SAMPLE,          // sampling and writing every sequence of one timeline in UpdateTimeline, UpdateMappedTimeline or the
+                     // editor. only the evaluate phase of UpdateTimelines and UpdateTimelinesParallel
+    WRITE,           // writing one value into a component field
+    DESERIALIZE,     // Tanim::Deserialize, DeserializeStream and DeserializeBinary
+    SEQUENCER_EDIT,  // the curve editor of an expanded sequence
+    TIMELINER,       // the timeliner window
+    COUNT
+};
+
+/// counted work, see Profiler::GetCounter. counted on every thread
+enum class ProfileCounter : uint8_t
+{
+    SEQUENCES_SAMPLED,  // sequences evaluated
+    CURVES_EVALUATED,   // curves sampled. a quaternion counts as its 4 curves
+    NEWTON_ITERATIONS,  // Newton-Raphson iterations of FindTForX
+    WRITES,             // values written into component fields
+    WRITES_SKIPPED,     // sequences not sampled or written because they held their value, see FindSequenceHold
+    COUNT
+};
+
+struct ProfileScopeStats
+{
+    int64_t m_calls{0};
+    double m_total_ms{0.0};
+    double m_last_ms{0.0};
+    double m_max_ms{0.0};
+};
+
+/// what the updates of one timeline cost, over all its instances since the last Profiler::Reset
+struct TimelineStats
+{
+    const TimelineData* m_timeline{nullptr};  // identifies the timeline, never read through
+    std::string m_name{};
+    int64_t m_updates{0};
+    double m_total_ms{0.0};
+    double m_last_ms{0.0};
+    double m_max_ms{0.0};
+    std::array<int64_t, static_cast<size_t>(ProfileCounter::COUNT)> m_counters{};  // indexed by ProfileCounter
+
+    [[nodiscard]] int64_t Get(ProfileCounter counter) const { return m_counters.at(static_cast<size_t>(counter)); }
+};
+
+class Profiler
+{
+public:
+    using CounterSnapshot = std::array<int64_t, static_cast<size_t>(ProfileCounter::COUNT)>;
+
+    static void Count(ProfileCounter counter, int64_t amount = 1)
+    {
+        m_counters.at(static_cast<size_t>(counter)).fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] static int64_t GetCounter(ProfileCounter counter)
+    {
+        return m_counters.at(static_cast<size_t>(counter)).load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] static CounterSnapshot GetCounters();
+
+    /// scope times are added on the calling thread of the updates and the editor only
+    static void AddScopeTime(ProfileScope scope, double ms);
+
+    [[nodiscard]] static const ProfileScopeStats& GetScopeStats(ProfileScope scope)
+    {
+        return m_scopes.at(static_cast<size_t>(scope));
+    }
+
+    /// adds one update of tdata: its time and the counters since before, a snapshot from GetCounters
+    static void AddTimelineUpdate(const TimelineData& tdata, const CounterSnapshot& before, double ms);
+
+    /// one entry per timeline updated since the last Reset, in the order they were first updated
+    [[nodiscard]] static const std::vector<TimelineStats>& GetTimelineStats() { return m_timelines; }
+
+    /// nullptr if tdata was not updated since the last Reset
+    [[nodiscard]] static const TimelineStats* FindTimelineStats(const TimelineData& tdata);
+
+    /// clears every stat and counter. call it e.g. when timelines are destroyed, their entries are kept until then
+    static void Reset();
+
+    /// contents of the "Profiler" window of Tanim::Draw
+    static void Draw();
+
+private:
+    static inline std::array<std::atomic<int64_t>, static_cast<size_t>(ProfileCounter::COUNT)> m_counters{};
+    static inline std::array<ProfileScopeStats, static_cast<size_t>(ProfileScope::COUNT)> m_scopes{};
+    static inline std::vector<TimelineStats> m_timelines{};
+};
+
+/// adds its lifetime to a ProfileScope
+class ProfileTimer
+{
+public:
+    explicit ProfileTimer(ProfileScope scope) : m_scope(scope), m_start(std::chrono::steady_clock::now()) {}
+    ~ProfileTimer()
+    {
+        Profiler::AddScopeTime(m_scope,
+                               std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count());
+    }
+
+    ProfileTimer(const ProfileTimer&) = delete;
+    ProfileTimer& operator=(const ProfileTimer&) = delete;
+
+private:
+    ProfileScope m_scope;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/// adds its lifetime and the counted work meanwhile to the TimelineStats of a timeline
+class TimelineProfileTimer
+{
+public:
+    explicit TimelineProfileTimer(const TimelineData& tdata)
+        : m_tdata(tdata), m_before(Profiler::GetCounters()), m_start(std::chrono::steady_clock::now())
+    {
+    }
+    ~TimelineProfileTimer()
+    {
+        Profiler::AddTimelineUpdate(
+            m_tdata,
+            m_before,
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count());
+    }
+
+    TimelineProfileTimer(const TimelineProfileTimer&) = delete;
+    TimelineProfileTimer& operator=(const TimelineProfileTimer&) = delete;
+
+private:
+    const TimelineData& m_tdata;
+    Profiler::CounterSnapshot m_before;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+}  // namespace tanim
+
+#define TANIM_PROFILE_CONCAT_IMPL(a, b) a##b
+#define TANIM_PROFILE_CONCAT(a, b) TANIM_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef TANIM_PROFILING
+#define TANIM_PROFILE_SCOPE(scope) const ::tanim::ProfileTimer TANIM_PROFILE_CONCAT(tanim_profile_timer_, __LINE__)(scope)
+#define TANIM_PROFILE_TIMELINE(tdata) \
+    const ::tanim::TimelineProfileTimer TANIM_PROFILE_CONCAT(tanim_profile_timeline_, __LINE__)(tdata)
+#define TANIM_PROFILE_COUNT(counter, amount) ::tanim::Profiler::Count(counter, amount)
+#else
+#define TANIM_PROFILE_SCOPE(scope) static_cast<void>(0)
+#define TANIM_PROFILE_TIMELINE(tdata) static_cast<void>(0)
+#define TANIM_PROFILE_COUNT(counter, amount) static_cast<void>(0)
+#endif
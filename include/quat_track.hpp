@@ -0,0 +1,66 @@
+#pragma once
+
+#include "tanim/include/keyframe.hpp"
+#include "tanim/include/includes.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace tanim
+{
+
+// === Compiled Quaternion Tracks ===
+// playback form of the five runtime curves of a quaternion sequence (W, X, Y, Z, Spins): one contiguous record per keyframe,
+// holding what glm::slerp would otherwise work out on every sample (the shorter-way target, theta, 1 / sin theta).
+// SampleQuatTrack gives the results of SampleQuatCurves up to float rounding, except that segments turning less than
+// kQuatNlerpMaxAngle without spins are nlerped, which is off by less than 5e-6 radians
+
+/// segments whose keyframes are closer than this (the angle between the quaternions) and have no spins are nlerped
+constexpr float kQuatNlerpMaxAngle = 0.05f;
+
+/// how the segment starting at a QuatTrackKey is interpolated
+enum class QuatSegmentMode : uint8_t
+{
+    SLERP,
+    LERP,      // keyframes too close for slerp to divide by sin theta, lerped like glm::slerp does
+    NLERP,     // under kQuatNlerpMaxAngle without spins
+    CONSTANT,  // holds m_quat: CONSTANT out-handle of W, or a zero-length segment
+};
+
+struct QuatTrackKey
+{
+    float m_time{0.0f};
+    glm::quat m_quat{1.0f, 0.0f, 0.0f, 0.0f};
+
+    // the segment to the next keyframe. unused on the last one
+    glm::quat m_target{1.0f, 0.0f, 0.0f, 0.0f};  // the next keyframe, negated when that is the shorter way
+    float m_inv_duration{0.0f};
+    float m_theta{0.0f};  // angle between m_quat and m_target
+    float m_phi{0.0f};    // m_theta + spins * pi
+    float m_inv_sin_theta{0.0f};
+    int16_t m_spins{0};   // Spins curve value at the next keyframe
+    QuatSegmentMode m_mode{QuatSegmentMode::CONSTANT};
+    bool m_flat{false};   // FLAT out-handle of W: t eased with smoothstep
+};
+
+struct QuatTrack
+{
+    std::vector<QuatTrackKey> m_keys{};
+    std::array<uint32_t, 5> m_revisions{};  // RuntimeCurve::m_revision of the curves it was compiled from, 0 = never compiled
+};
+
+/// compiles the runtime curves of a quaternion sequence. the curves must have the keyframe times of curve_w
+QuatTrack CompileQuatTrack(const RuntimeCurveView& curve_w,
+                           const RuntimeCurveView& curve_x,
+                           const RuntimeCurveView& curve_y,
+                           const RuntimeCurveView& curve_z,
+                           const RuntimeCurveView& curve_spins);
+
+// Quaternion playback on a compiled track, same results as SampleQuatCurves (see above)
+glm::quat SampleQuatTrack(const QuatTrack& track, float time);
+
+// Same as above, using (and updating) a playback cursor to find the segment. See FindSegmentIndex.
+glm::quat SampleQuatTrack(const QuatTrack& track, float time, int& cursor);
+
+}  // namespace tanim
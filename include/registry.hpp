@@ -5,8 +5,9 @@
 #include "tanim/include/includes.hpp"
 #include "tanim/include/enums.hpp"
 
-#include <functional>
+#include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace tanim
@@ -23,25 +24,52 @@ struct RegisteredComponent
     std::vector<std::string> m_field_names{};
     std::vector<std::string> m_struct_field_names{};
 
-    std::function<void(const entt::registry& entt_registry,
-                       TimelineData& timeline_data,
-                       const ComponentData& component_data,
-                       SequenceId& seq_id)>
-        m_add_sequence;
+    // plain function pointers, instantiated for the registered component type by Registry::RegisterComponent
+    using AddSequenceFn = void (*)(const entt::registry& entt_registry,
+                                   TimelineData& timeline_data,
+                                   const ComponentData& component_data,
+                                   SequenceId& seq_id);
+    using InspectFn = void (*)(entt::registry& entt_registry, entt::entity entity, int player_frame, Sequence& seq);
+    using RecordFn = void (*)(const entt::registry& entt_registry, entt::entity entity, int recording_frame, Sequence& seq);
+    using EntityHasFn = bool (*)(const entt::registry& entt_registry, entt::entity entity);
 
-    std::function<void(entt::registry& entt_registry, entt::entity entity, float sample_time, Sequence& seq)> m_sample;
+    AddSequenceFn m_add_sequence{nullptr};
+    InspectFn m_inspect{nullptr};
+    RecordFn m_record{nullptr};
+    EntityHasFn m_entity_has{nullptr};
 
-    std::function<void(entt::registry& entt_registry, entt::entity entity, int player_frame, Sequence& seq)> m_inspect;
-
-    std::function<void(const entt::registry& entt_registry, entt::entity entity, int recording_frame, Sequence& seq)> m_record;
-
-    std::function<bool(const entt::registry& entt_registry, entt::entity entity)> m_entity_has;
+    /// one writer per field in visit order, each specialised for its field. playback caches them per sequence, see
+    /// ComponentData::m_cached_writers
+    std::vector<FieldWriter> m_field_writers{};
 
     bool HasStructFieldName(const std::string& struct_field_name) const
     {
         return std::find(m_struct_field_names.begin(), m_struct_field_names.end(), struct_field_name) !=
                m_struct_field_names.end();
     }
+
+    /// @return index of the field in visit order, -1 if this component has no such field
+    int FindFieldIndex(const std::string& field_name) const
+    {
+        const auto it = std::find(m_field_names.begin(), m_field_names.end(), field_name);
+        return it == m_field_names.end() ? -1 : static_cast<int>(it - m_field_names.begin());
+    }
+
+    /// resolves seq's field name to a field index once, so sampling does no string work
+    void BindField(Sequence& seq) const
+    {
+        if (seq.m_field_index < 0)
+        {
+            seq.m_field_index = FindFieldIndex(seq.m_seq_id.FieldName());
+        }
+    }
+
+    /// @return the writer of the field_index-th field, nullptr if this component has no such field
+    FieldWriter GetFieldWriter(int field_index) const
+    {
+        if (field_index < 0 || field_index >= static_cast<int>(m_field_writers.size())) return nullptr;
+        return m_field_writers.at(field_index);
+    }
 };
 
 namespace reflection
@@ -219,80 +247,161 @@ static void AddSequence(T& ecs_component, TimelineData& timeline_data, SequenceI
         });
 }
 
-template <typename T>
-static void Sample(T& ecs_component, float sample_time, Sequence& seq)
+/// evaluates seq's curves at sample_time without touching any component. quaternions are (w, x, y, z)
+inline SampledValue EvaluateSequence(Sequence& seq, float sample_time)
 {
-    visit_struct::context<VSContext>::for_each(
-        ecs_component,
-        [&seq, &sample_time](const char* field_name, auto& field)
+    TANIM_PROFILE_COUNT(ProfileCounter::SEQUENCES_SAMPLED, 1);
+
+    SampledValue value{};
+    if (seq.m_representation_meta == RepresentationMeta::QUAT)
+    {
+        sequencer::UpdateQuatTrack(seq);
+        const glm::quat q = sequencer::SampleQuatForAnimation(seq, sample_time, seq.m_curves.at(0).m_playback_cursor);
+        value = {q.w, q.x, q.y, q.z};
+    }
+    else
+    {
+        const int curve_count = std::min(seq.GetCurveCount(), static_cast<int>(value.size()));
+        for (int curve_idx = 0; curve_idx < curve_count; ++curve_idx)
         {
-            using FieldType = std::decay_t<decltype(field)>;
-            const std::string field_name_str = field_name;
-            const std::string struct_name = visit_struct::get_name<T>();
-            const std::string struct_field_name = helpers::MakeStructFieldName(struct_name, field_name_str);
-            if (struct_field_name == seq.m_seq_id.StructFieldName())
-            {
-                if constexpr (std::is_same_v<FieldType, float>)
-                {
-                    field = SampleCurveValue(seq.m_curves.at(0), sample_time);
-                }
-                else if constexpr (std::is_same_v<FieldType, int>)
-                {
-                    field = SampleCurveValue(seq.m_curves.at(0), sample_time);
-                    field = static_cast<int>(std::floorf(field));
-                }
-                else if constexpr (std::is_same_v<FieldType, bool>)
-                {
-                    field = SampleCurveValue(seq.m_curves.at(0), sample_time);
-                    field = std::round(field) >= 0.5f ? true : false;
-                }
-                else if constexpr (std::is_same_v<FieldType, glm::vec2>)
-                {
-                    field.x = SampleCurveValue(seq.m_curves.at(0), sample_time);
-                    field.y = SampleCurveValue(seq.m_curves.at(1), sample_time);
-                }
-                else if constexpr (std::is_same_v<FieldType, glm::vec3>)
-                {
-                    field.x = SampleCurveValue(seq.m_curves.at(0), sample_time);
-                    field.y = SampleCurveValue(seq.m_curves.at(1), sample_time);
-                    field.z = SampleCurveValue(seq.m_curves.at(2), sample_time);
-                }
-                else if constexpr (std::is_same_v<FieldType, glm::vec4>)
-                {
-                    switch (seq.m_representation_meta)
-                    {
-                        case RepresentationMeta::COLOR:
-                        {
-                            field.r = SampleCurveValue(seq.m_curves.at(0), sample_time);
-                            field.g = SampleCurveValue(seq.m_curves.at(1), sample_time);
-                            field.b = SampleCurveValue(seq.m_curves.at(2), sample_time);
-                            field.a = SampleCurveValue(seq.m_curves.at(3), sample_time);
+            value.at(curve_idx) = seq.SampleCurve(curve_idx, sample_time);
+        }
+    }
+    return value;
+}
 
-                            break;
-                        }
-                        case RepresentationMeta::QUAT:
-                        {
-                            const glm::quat q = sequencer::SampleQuatForAnimation(seq, sample_time);
-                            field = {q.w, q.x, q.y, q.z};
+/// same as EvaluateSequence, but leaves the playback cursors alone, so one sequence can be evaluated from several threads
+inline SampledValue EvaluateSequenceThreadSafe(const Sequence& seq, float sample_time)
+{
+    TANIM_PROFILE_COUNT(ProfileCounter::SEQUENCES_SAMPLED, 1);
 
-                            break;
-                        }
-                        case RepresentationMeta::VECTOR:
-                        case RepresentationMeta::NONE:
-                        default:
-                            assert(0);  // unhandled RepresentaionMeta
-                    }
-                }
-                else if constexpr (std::is_same_v<FieldType, glm::quat>)
-                {
-                    field = sequencer::SampleQuatForAnimation(seq, sample_time);
-                }
-                else
-                {
-                    static_assert(false, "Unsupported Type");
-                }
+    SampledValue value{};
+    if (seq.m_representation_meta == RepresentationMeta::QUAT)
+    {
+        const glm::quat q = sequencer::SampleQuatForAnimation(seq, sample_time);
+        value = {q.w, q.x, q.y, q.z};
+    }
+    else
+    {
+        const int curve_count = std::min(seq.GetCurveCount(), static_cast<int>(value.size()));
+        for (int curve_idx = 0; curve_idx < curve_count; ++curve_idx)
+        {
+            value.at(curve_idx) = SampleRuntimeCurve(seq.m_curves.at(curve_idx).m_runtime, sample_time);
+        }
+    }
+    return value;
+}
+
+/// times around sample_time over which EvaluateSequence keeps giving its value at sample_time: the overlap of the holds of
+/// the curves (see FindRuntimeHold). empty if the value changes at sample_time. leaves the playback cursors alone
+inline HoldSpan FindSequenceHold(const Sequence& seq, float sample_time)
+{
+    if (seq.m_representation_meta == RepresentationMeta::QUAT)
+    {
+        int cursor = seq.m_curves.at(0).m_playback_cursor;
+        return sequencer::FindQuatHold(seq.m_curves.at(0).m_runtime,
+                                       seq.m_curves.at(1).m_runtime,
+                                       seq.m_curves.at(2).m_runtime,
+                                       seq.m_curves.at(3).m_runtime,
+                                       seq.m_curves.at(4).m_runtime,
+                                       sample_time,
+                                       cursor);
+    }
+
+    HoldSpan hold{-std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()};
+    const int curve_count = std::min(seq.GetCurveCount(), static_cast<int>(SampledValue{}.size()));
+    for (int curve_idx = 0; curve_idx < curve_count && hold.m_begin < hold.m_end; ++curve_idx)
+    {
+        const Curve& curve = seq.m_curves.at(curve_idx);
+        int cursor = curve.m_playback_cursor;
+        const HoldSpan curve_hold = FindRuntimeHold(curve.m_runtime, sample_time, cursor);
+        hold = {std::max(hold.m_begin, curve_hold.m_begin), std::min(hold.m_end, curve_hold.m_end)};
+    }
+    return hold.m_begin < hold.m_end ? hold : HoldSpan{};
+}
+
+template <typename T, std::size_t I>
+static void WriteField(T& ecs_component, RepresentationMeta representation_meta, const SampledValue& value)
+{
+    auto& field = visit_struct::get<I>(ecs_component);
+    using FieldType = std::decay_t<decltype(field)>;
+
+    if constexpr (std::is_same_v<FieldType, float>)
+    {
+        field = value.at(0);
+    }
+    else if constexpr (std::is_same_v<FieldType, int>)
+    {
+        field = value.at(0);
+        field = static_cast<int>(std::floorf(field));
+    }
+    else if constexpr (std::is_same_v<FieldType, bool>)
+    {
+        field = value.at(0);
+        field = std::round(field) >= 0.5f ? true : false;
+    }
+    else if constexpr (std::is_same_v<FieldType, glm::vec2>)
+    {
+        field.x = value.at(0);
+        field.y = value.at(1);
+    }
+    else if constexpr (std::is_same_v<FieldType, glm::vec3>)
+    {
+        field.x = value.at(0);
+        field.y = value.at(1);
+        field.z = value.at(2);
+    }
+    else if constexpr (std::is_same_v<FieldType, glm::vec4>)
+    {
+        switch (representation_meta)
+        {
+            case RepresentationMeta::COLOR:
+            case RepresentationMeta::QUAT:
+            {
+                field = {value.at(0), value.at(1), value.at(2), value.at(3)};
+
+                break;
             }
-        });
+            case RepresentationMeta::VECTOR:
+            case RepresentationMeta::NONE:
+            default:
+                assert(0);  // unhandled RepresentaionMeta
+        }
+    }
+    else if constexpr (std::is_same_v<FieldType, glm::quat>)
+    {
+        field = glm::quat(value.at(0), value.at(1), value.at(2), value.at(3));
+    }
+    else
+    {
+        static_assert(false, "Unsupported Type");
+    }
+}
+
+/// the FieldWriter of the I-th field of T: writes a value made by EvaluateSequence into that field of entity's T
+template <typename T, std::size_t I>
+void WriteEntityField(entt::registry& entt_registry,
+                      entt::entity entity,
+                      RepresentationMeta representation_meta,
+                      const SampledValue& value)
+{
+    T* ecs_component = entt_registry.try_get<T>(entity);
+    if (ecs_component == nullptr)
+    {
+        LogError("entity " + std::to_string(entt::to_integral(entity)) + " does not have a component named " +
+                 visit_struct::get_name<T>());
+        return;
+    }
+
+    TANIM_PROFILE_SCOPE(ProfileScope::WRITE);
+    TANIM_PROFILE_COUNT(ProfileCounter::WRITES, 1);
+    WriteField<T, I>(*ecs_component, representation_meta, value);
+}
+
+template <typename T, std::size_t... Is>
+std::vector<FieldWriter> MakeFieldWriters(std::index_sequence<Is...>)
+{
+    return {&WriteEntityField<T, Is>...};
 }
 
 inline void SyncAllHandleTypesInCurve(Sequence& seq, CurveHandleType curve_handle_type, int curves_count)
@@ -929,21 +1038,8 @@ public:
             }
         };
 
-        registered_component.m_sample = [](entt::registry& entt_registry, entt::entity entity, float sample_time, Sequence& seq)
-        {
-            if (entity != entt::null)
-            {
-                if (entt_registry.all_of<T>(entity))
-                {
-                    reflection::Sample(entt_registry.get<T>(entity), sample_time, seq);
-                }
-                else
-                {
-                    LogError("entity " + std::to_string(entt::to_integral(entity)) + " does not have a component named " +
-                             visit_struct::get_name<T>());
-                }
-            }
-        };
+        registered_component.m_field_writers =
+            reflection::MakeFieldWriters<T>(std::make_index_sequence<visit_struct::field_count<T>()>{});
 
         registered_component.m_inspect = [](entt::registry& entt_registry, entt::entity entity, int player_frame, Sequence& seq)
         {
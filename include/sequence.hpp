@@ -7,16 +7,31 @@
 #include "tanim/include/keyframe.hpp"
 #include "tanim/include/curve_functions.hpp"
 #include "tanim/include/bezier.hpp"
+#include "tanim/include/quat_track.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <optional>
+#include <span>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace tanim
 {
 
+/// curve values of one sequence at one sample time. up to 4 curves, quaternions are (w, x, y, z)
+using SampledValue = std::array<float, 4>;
+
+/// one keyframe for every curve of a sequence, see Sequence::AddKeyframes
+struct SequenceKeyframe
+{
+    float m_frame{0.0f};
+    SampledValue m_value{};  // one value per curve, same layout as SampledValue
+};
+
 struct Sequence
 {
     enum class TypeMeta : uint8_t
@@ -35,10 +50,14 @@ struct Sequence
     int m_last_frame{10};
     bool m_expanded{false};
     SequenceId m_seq_id{};
+    int m_field_index{-1};  // index of m_seq_id's field in its component, -1 until bound. see RegisteredComponent::BindField
     bool m_recording{false};
     int m_recording_frame{-1};
     float m_snap_y_value = 0.1f;
     bool m_focused{true};
+    bool m_static{false};  // not serialized. its value never changes, see Tanim::BakeStaticSequences
+    std::array<uint32_t, 5> m_static_revisions{};  // RuntimeCurve::m_revision of its curves when m_static was baked
+    QuatTrack m_quat_track{};  // not serialized. playback form of a quaternion sequence, see sequencer::UpdateQuatTrack
 
     Curve& AddCurve() { return m_curves.emplace_back(); }
 
@@ -137,12 +156,31 @@ struct Sequence
 
     int GetCurveCount() const { return static_cast<int>(m_curves.size()); }
 
+    // RuntimeCurve::m_revision of every curve, 0 past the last one. differs after any edit of a curve
+    std::array<uint32_t, 5> GetCurveRevisions() const
+    {
+        std::array<uint32_t, 5> revisions{};
+        const int curve_count = std::min(GetCurveCount(), static_cast<int>(revisions.size()));
+        for (int curve_idx = 0; curve_idx < curve_count; ++curve_idx)
+        {
+            revisions.at(curve_idx) = m_curves.at(curve_idx).m_runtime.m_revision;
+        }
+        return revisions;
+    }
+
     bool GetCurveVisibility(int curve_idx) const { return m_curves.at(curve_idx).m_visibility; }
 
     void SetCurveVisibility(int curve_idx, bool visibility) { m_curves.at(curve_idx).m_visibility = visibility; }
 
     int GetCurveKeyframeCount(int curve_idx) const { return GetKeyframeCount(m_curves.at(curve_idx)); }
 
+    // Sample a curve for playback, advancing its playback cursor
+    float SampleCurve(int curve_idx, float time)
+    {
+        Curve& curve = m_curves.at(curve_idx);
+        return SampleCurveValue(curve, time, curve.m_playback_cursor);
+    }
+
     static uint32_t GetCurveColor(int curve_index)
     {
         // TODO(tanim) replace hardcoded colors
@@ -236,6 +274,46 @@ struct Sequence
         return AddKeyframe(m_curves.at(curve_idx), pos.x, pos.y);
     }
 
+    // Add a keyframe per key to every curve, each curve sorted and resolved once (see AddKeyframes in curve_functions).
+    // Frames are snapped like AddKeyframeAtPos, the spins curve of a quaternion gets 0 spins.
+    // Returns the number of keyframes added to each curve.
+    int AddKeyframes(std::span<const SequenceKeyframe> keys)
+    {
+        const bool is_quat = m_representation_meta == RepresentationMeta::QUAT;
+
+        std::vector<std::pair<float, float>> curve_keys{};
+        curve_keys.reserve(keys.size());
+
+        int added = 0;
+        for (int curve_idx = 0; curve_idx < GetCurveCount(); ++curve_idx)
+        {
+            curve_keys.clear();
+            for (const auto& key : keys)
+            {
+                const float value = (is_quat && curve_idx == 4) ? 0.0f : key.m_value.at(curve_idx);
+                curve_keys.emplace_back(std::floor(key.m_frame), value);
+            }
+
+            const int curve_added = tanim::AddKeyframes(m_curves.at(curve_idx), curve_keys);
+            if (curve_idx == 0) added = curve_added;
+        }
+        return added;
+    }
+
+    // Same as above from (frame, field value) pairs, for a float, int, bool, glm::vec2/3/4 or glm::quat field.
+    // Call it as seq.AddKeyframes<glm::vec3>(keys)
+    template <typename FieldType>
+    int AddKeyframes(std::span<const std::pair<float, FieldType>> keys)
+    {
+        std::vector<SequenceKeyframe> sequence_keys{};
+        sequence_keys.reserve(keys.size());
+        for (const auto& [frame, field] : keys)
+        {
+            sequence_keys.push_back({frame, FieldToSampledValue(field)});
+        }
+        return AddKeyframes(std::span<const SequenceKeyframe>(sequence_keys));
+    }
+
     void RemoveKeyframeAtIdx(int curve_idx, int keyframe_idx) { RemoveKeyframe(m_curves.at(curve_idx), keyframe_idx); }
 
     std::optional<int> GetKeyframeIdx(int curve_idx, int frame_num) const
@@ -295,6 +373,9 @@ struct Sequence
                                                   static_cast<float>(m_last_frame),
                                                   keyframe.m_pos.x);
             }
+
+            // every keyframe moved, so the whole runtime form is stale, not just the first keyframe's
+            ResolveCurveHandles(curve);
         }
 
         m_first_frame = new_first_frame;
@@ -341,7 +422,8 @@ struct Sequence
             {
                 key.m_pos.x += frame_diff_f;
             }
-            ResolveCurveHandles(curve);
+            // handle offsets are relative to their keyframe, so a shift only changes the runtime form
+            CompileCurve(curve);
         }
     }
 
@@ -452,6 +534,41 @@ struct Sequence
     }
 
 private:
+    // curve values of a field, in the order recording writes them
+    template <typename FieldType>
+    SampledValue FieldToSampledValue(const FieldType& field) const
+    {
+        if constexpr (std::is_same_v<FieldType, float> || std::is_same_v<FieldType, int>)
+        {
+            return {static_cast<float>(field), 0.0f, 0.0f, 0.0f};
+        }
+        else if constexpr (std::is_same_v<FieldType, bool>)
+        {
+            return {field ? 1.0f : 0.0f, 0.0f, 0.0f, 0.0f};
+        }
+        else if constexpr (std::is_same_v<FieldType, glm::vec2>)
+        {
+            return {field.x, field.y, 0.0f, 0.0f};
+        }
+        else if constexpr (std::is_same_v<FieldType, glm::vec3>)
+        {
+            return {field.x, field.y, field.z, 0.0f};
+        }
+        else if constexpr (std::is_same_v<FieldType, glm::vec4>)
+        {
+            if (m_representation_meta == RepresentationMeta::QUAT) return {field.w, field.x, field.y, field.z};
+            return {field.r, field.g, field.b, field.a};
+        }
+        else if constexpr (std::is_same_v<FieldType, glm::quat>)
+        {
+            return {field.w, field.x, field.y, field.z};
+        }
+        else
+        {
+            static_assert(false, "Unsupported Type");
+        }
+    }
+
     void ClampFirstKeyframesToFirstFrame()
     {
         const int curve_count = GetCurveCount();
@@ -463,7 +580,7 @@ private:
             if (keyframe_count > 0)
             {
                 curve.m_keyframes.at(0).m_pos.x = static_cast<float>(m_first_frame);
-                ResolveCurveHandles(curve);
+                ResolveKeyframeRange(curve, 0, 0);
             }
         }
     }
@@ -478,7 +595,7 @@ private:
             if (keyframe_count > 0)
             {
                 curve.m_keyframes.at(keyframe_count - 1).m_pos.x = static_cast<float>(m_last_frame);
-                ResolveCurveHandles(curve);
+                ResolveKeyframeRange(curve, keyframe_count - 1, keyframe_count - 1);
             }
         }
     }
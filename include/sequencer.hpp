@@ -35,6 +35,8 @@ struct ImRect;
 namespace tanim
 {
 struct Sequence;
+struct RuntimeCurveView;
+struct HoldSpan;
 }
 
 namespace tanim::sequencer
@@ -67,6 +69,36 @@ int Edit(Sequence& seq,
          const ImRect* clipping_rect = nullptr,
          ImVector<EditPoint>* selected_points = nullptr);
 
-glm::quat SampleQuatForAnimation(Sequence& seq, float time);
+// Stateless, safe to call for the same sequence from several threads.
+// Samples seq.m_quat_track when it is current, the runtime curves otherwise
+glm::quat SampleQuatForAnimation(const Sequence& seq, float time);
+
+// Same as above, using (and updating) a playback cursor to find the segment. See FindSegmentIndex.
+glm::quat SampleQuatForAnimation(const Sequence& seq, float time, int& cursor);
+
+// Whether seq.m_quat_track was compiled from the current runtime curves of the quaternion sequence seq
+bool IsQuatTrackCurrent(const Sequence& seq);
+
+// Recompile seq.m_quat_track unless it is current. Called before playback, e.g. by EvaluateSequence and BindTimeline
+void UpdateQuatTrack(Sequence& seq);
+
+// Quaternion playback on the five runtime curves of a quaternion sequence (W, X, Y, Z, Spins), e.g. of a MappedTimeline
+glm::quat SampleQuatCurves(const RuntimeCurveView& curve_w,
+                           const RuntimeCurveView& curve_x,
+                           const RuntimeCurveView& curve_y,
+                           const RuntimeCurveView& curve_z,
+                           const RuntimeCurveView& curve_spins,
+                           float time,
+                           int& cursor);
+
+// Times around time over which SampleQuatCurves keeps returning its value at time, see FindRuntimeHold.
+// Holds before the first and after the last keyframe, on CONSTANT segments and between equal keyframes without spins.
+HoldSpan FindQuatHold(const RuntimeCurveView& curve_w,
+                      const RuntimeCurveView& curve_x,
+                      const RuntimeCurveView& curve_y,
+                      const RuntimeCurveView& curve_z,
+                      const RuntimeCurveView& curve_spins,
+                      float time,
+                      int& cursor);
 
 }  // namespace tanim::sequencer
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "tanim/include/sequence.hpp"
+
+#include <vector>
+
+namespace tanim
+{
+
+// === Static Sequences ===
+// a sequence whose value never changes (e.g. the two equal default keyframes of reflection::AddSequence) is static.
+// Tanim::BakeStaticSequences flags them, so every start writes them once and the updates only loop over the others.
+// segments between equal keyframes with level handles are flagged CompiledSegment::m_level whenever a curve is compiled,
+// and sampled like CONSTANT segments, without any Bezier math.
+
+/// what Tanim::BakeStaticSequences found in one sequence
+struct SequenceStaticReport
+{
+    int m_seq_idx{-1};
+    bool m_static{false};
+    int m_segments{0};
+    int m_constant_segments{0};
+    int m_level_segments{0};
+};
+
+/// result of Tanim::BakeStaticSequences
+struct StaticBakeReport
+{
+    int m_static_sequences{0};   // evaluations and writes each update no longer does, per instance
+    int m_dynamic_sequences{0};
+    int m_segments{0};
+    int m_constant_segments{0};  // CONSTANT segments
+    int m_level_segments{0};     // segments between equal keyframes with level handles
+    std::vector<SequenceStaticReport> m_sequences{};
+};
+
+/// whether every curve of runtime holds one value: its keyframes are equal and every segment is CONSTANT or level
+bool IsRuntimeCurveStatic(const RuntimeCurveView& runtime);
+
+/// whether EvaluateSequence gives seq the same value at every time. quaternion sequences need equal keyframes and no spins
+bool IsSequenceStatic(const Sequence& seq);
+
+/// whether seq was baked static and none of its curves changed since, e.g. by AddKeyframe while playing
+bool IsStaticBakeCurrent(const Sequence& seq);
+
+}  // namespace tanim
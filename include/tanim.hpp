@@ -2,6 +2,18 @@
 #include "registry.hpp"
 #include "tanim/include/timeline.hpp"
 #include "tanim/include/entity_data.hpp"
+#include "tanim/include/alloc_tracking.hpp"
+#include "tanim/include/profiler.hpp"
+#include "tanim/include/baked_timeline.hpp"
+#include "tanim/include/curve_lut.hpp"
+#include "tanim/include/curve_reduce.hpp"
+#include "tanim/include/static_bake.hpp"
+#include "tanim/include/thread_pool.hpp"
+
+#include <atomic>
+#include <iosfwd>
+#include <memory>
+#include <span>
 
 namespace tanim
 {
@@ -29,8 +41,60 @@ public:
                                ComponentData& component_data,
                                float delta_time);
 
+    /// updates many instances of one timeline. curves are sampled once per distinct sample time and written to each instance.
+    /// instances are bound with the entity datas of their last BindTimeline/UpdateTimeline, so bind each instance once first.
+    /// snap_to_frames samples at whole frames, so instances within the same frame share one sample
+    static void UpdateTimelines(entt::registry& registry,
+                                TimelineData& timeline_data,
+                                std::span<ComponentData> instances,
+                                float delta_time,
+                                bool snap_to_frames = false);
+
+    /// same as UpdateTimelines, but the curves are evaluated in parallel through the task dispatcher (see SetTaskDispatcher).
+    /// the registry is still written on the calling thread, after all evaluations finished
+    static void UpdateTimelinesParallel(entt::registry& registry,
+                                        TimelineData& timeline_data,
+                                        std::span<ComponentData> instances,
+                                        float delta_time,
+                                        bool snap_to_frames = false);
+
+    /// same as UpdateTimeline, but the sequences are evaluated in parallel. worth it for timelines with many sequences
+    static void UpdateTimelineParallel(entt::registry& registry,
+                                       const std::vector<EntityData>& entity_datas,
+                                       TimelineData& timeline_data,
+                                       ComponentData& component_data,
+                                       float delta_time);
+
+    /// runs the parallel updates on an engine job system. an empty dispatcher falls back to the built-in ThreadPool
+    static void SetTaskDispatcher(TaskDispatcher task_dispatcher);
+
     static void StopTimeline(ComponentData& component_data);
 
+    /// resolves every sequence to its RegisteredComponent and entity once. Called by UpdateTimeline when the bindings are stale
+    static void BindTimeline(const std::vector<EntityData>& entity_datas,
+                             TimelineData& timeline_data,
+                             ComponentData& component_data);
+
+    /// call when the entity hierarchy of component_data changes, so its sequences are bound again on the next update
+    static void InvalidateBindings(ComponentData& component_data);
+
+    /// the updates skip sampling and writing a sequence while its value cannot have changed since its last write
+    /// (see FindSequenceHold), so component observers only fire on real changes. call this when the curves of a playing
+    /// timeline were edited outside the editor, or the fields were written by something else, so every sequence is
+    /// written again on the next update. the timeline open in the editor is always written
+    static void InvalidateHolds(ComponentData& component_data);
+
+    /// turns the skipping of held sequences on (the default) or off, for every update
+    static void SetSkipHeldSequences(bool skip) { m_skip_held_sequences = skip; }
+
+    /// heap allocations made by the last UpdateTimeline, UpdateTimelines(Parallel) or UpdateMappedTimeline.
+    /// always 0 without TANIM_TRACK_ALLOCATIONS, see alloc_tracking.hpp
+    static int64_t GetLastUpdateAllocations() { return m_last_update_allocations; }
+
+    /// with TANIM_TRACK_ALLOCATIONS: an update of a timeline whose playing instances were all already bound must not allocate.
+    /// if it does, it logs an error and asserts. the timeline open in the editor is not checked
+    static void SetPlaybackAllocationGuard(bool guard) { m_playback_allocation_guard = guard; }
+
     static bool IsPlaying(const ComponentData& component_data);
     static void Play(ComponentData& component_data);
     static void Pause(ComponentData& component_data);
@@ -43,6 +107,46 @@ public:
     [[nodiscard]] static std::string Serialize(TimelineData& tdata);
     static void Deserialize(TimelineData& data, const std::string& serialized_string);
 
+    /// same schema and checks as Deserialize, but fills data while input is read instead of parsing a JSON DOM first
+    /// @return false if input is not a valid timeline, data is left unchanged then
+    static bool DeserializeStream(TimelineData& data, std::istream& input);
+
+    /// compact binary form of Serialize. holds exactly what the version 2 JSON holds, see binary_format.cpp for the layout
+    [[nodiscard]] static std::vector<uint8_t> SerializeBinary(const TimelineData& tdata);
+    /// @return false if bytes is not a valid binary timeline, data is left unchanged then
+    static bool DeserializeBinary(TimelineData& data, std::span<const uint8_t> bytes);
+
+    /// bakes the runtime curves for read-only playback straight from a memory mapping, see MappedTimeline.
+    /// with quantize.m_enabled, curves on whole frames whose 16-bit form stays within quantize.m_max_error are stored
+    /// quantized (see curve_quantize.hpp). report, if given, tells how each curve was stored
+    [[nodiscard]] static std::vector<uint8_t> SerializeBaked(const TimelineData& tdata,
+                                                             const QuantizeSettings& quantize = {},
+                                                             QuantizeReport* report = nullptr);
+
+    /// resolves every sequence of mapped to its RegisteredComponent and entity. Called by UpdateMappedTimeline when needed
+    static void BindMappedTimeline(MappedTimeline& mapped, ComponentData& component_data);
+
+    /// UpdateTimeline for a MappedTimeline. start it with StartTimeline(mapped.GetTimelineData(), component_data)
+    static void UpdateMappedTimeline(entt::registry& registry,
+                                     MappedTimeline& mapped,
+                                     ComponentData& component_data,
+                                     float delta_time);
+
+    /// resamples the curves of tdata into uniform-time tables (see curve_lut.hpp), smallest tables first, until
+    /// settings.m_memory_budget is used up. quaternion sequences keep slerping between their keyframes
+    static LutBakeReport BakeTimelineLuts(TimelineData& tdata, const LutBakeSettings& settings = {});
+    static void ClearTimelineLuts(TimelineData& tdata);
+
+    /// removes keyframes from every curve of tdata while the result stays within the tolerances of settings
+    /// (see curve_reduce.hpp), and reports the compression ratio and max error of each curve
+    static ReduceReport ReduceTimeline(TimelineData& tdata, const ReduceSettings& settings = {});
+
+    /// flags the sequences of tdata whose value never changes (see static_bake.hpp). each start of a ComponentData writes
+    /// them on its first update, later updates skip them entirely. bake again after editing curves or adding sequences;
+    /// adding or removing sequences drops the flags until then. the timeline open in the editor ignores them
+    static StaticBakeReport BakeStaticSequences(TimelineData& tdata);
+    static void ClearStaticSequences(TimelineData& tdata);
+
     static void EnterPlayMode() { m_is_engine_in_play_mode = true; }
     static void ExitPlayMode() { m_is_engine_in_play_mode = false; }
 
@@ -56,14 +160,70 @@ private:
 
     static inline bool m_is_engine_in_play_mode{};
     static inline bool m_preview{true};
+    static inline bool m_skip_held_sequences{true};
+    static inline bool m_playback_allocation_guard{false};
+    static inline int64_t m_last_update_allocations{0};
 
     static inline bool m_force_editor_timeline_frame{false};
     static inline int m_forced_editor_timeline_frame{-1};
 
+    struct BatchEntry
+    {
+        float m_sample_time{0};
+        int m_player_frame{0};
+        int m_instance_idx{-1};
+        bool m_passed_last_frame{false};
+    };
+
+    // scratch buffers of UpdateTimelines, kept to reuse their capacity
+    static inline std::vector<BatchEntry> m_batch_entries{};
+    static inline std::vector<std::pair<int, int>> m_batch_groups{};
+    static inline std::vector<SampledValue> m_batch_values{};  // [group_idx * sequence count + seq_idx]
+    static inline std::vector<HoldSpan> m_batch_holds{};       // same layout, the holds of m_batch_values
+    static inline std::vector<uint8_t> m_batch_needed{};       // same layout, whether any instance of the group needs it
+
+    static inline TaskDispatcher m_task_dispatcher{};
+    static inline std::unique_ptr<ThreadPool> m_thread_pool{};  // created on first use when no dispatcher is set
+    static constexpr int m_evaluations_per_task{32};
+    // with TANIM_TRACK_ALLOCATIONS: allocations of dispatched tasks that ran on other threads than the dispatching one,
+    // which an AllocationScope of the update doesn't see. reset by the updates that dispatch
+    static inline std::atomic<int64_t> m_task_allocations{0};
+
+    // runs the tasks like DispatchTasks, adding the allocations of other threads to m_task_allocations
+    static void Dispatch(int task_count, const std::function<void(int task_idx)>& task);
+    static void DispatchTasks(int task_count, const std::function<void(int task_idx)>& task);
+
+    // returns whether every playing instance was already bound, for the allocation guard
+    static bool UpdateTimelinesImpl(entt::registry& registry,
+                                    TimelineData& tdata,
+                                    std::span<ComponentData> instances,
+                                    float delta_time,
+                                    bool snap_to_frames,
+                                    bool parallel);
+
     static void Sample(entt::registry& registry,
                        const std::vector<EntityData>& entity_datas,
                        TimelineData& tdata,
                        ComponentData& cdata);
+
+    // the editor edits curves without telling the players, so its timeline never skips
+    static bool SkipsHeldSequences(const TimelineData& tdata)
+    {
+        return m_skip_held_sequences && &tdata != m_editor_timeline_data;
+    }
+
+    // the hold of the value just written for seq: FindSequenceHold, or forever for a static sequence while statics are baked
+    static HoldSpan FindWriteHold(const Sequence& seq, bool statics, float sample_time);
+    // whether seq still holds its last written value at sample_time: inside its hold, and its curves weren't edited since
+    static bool IsHeld(const Sequence& seq, const ComponentData& cdata, int seq_idx, float sample_time);
+    static void SetHold(const Sequence& seq, ComponentData& cdata, int seq_idx, const HoldSpan& hold);
+    static void UpdateStaticsApplied(const TimelineData& tdata, ComponentData& cdata);
+
+    // empties the holds of cdata made while the statics were baked once they no longer are, so an edited static sequence plays
+    static void SyncStaticHolds(bool statics, ComponentData& cdata);
+
+    // stores the allocations of an update for GetLastUpdateAllocations. was_bound: checked by the allocation guard
+    static void RecordUpdateAllocations(const TimelineData& tdata, int64_t allocations, bool was_bound);
 };
 
 }  // namespace tanim
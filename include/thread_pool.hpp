@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tanim
+{
+
+/// runs task(task_idx) for every task_idx in [0, task_count) and returns once all of them have finished.
+/// tasks may run on any thread and in any order
+using TaskDispatcher = std::function<void(int task_count, const std::function<void(int task_idx)>& task)>;
+
+/// the default TaskDispatcher of Tanim: a fixed set of std::thread workers, the calling thread helps with the tasks
+class ThreadPool
+{
+public:
+    /// worker_count < 0 = one worker less than the hardware threads
+    explicit ThreadPool(int worker_count = -1);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// blocks until every task has run. not reentrant: don't call Run from inside a task
+    void Run(int task_count, const std::function<void(int task_idx)>& task);
+
+    int GetWorkerCount() const { return static_cast<int>(m_workers.size()); }
+
+private:
+    std::vector<std::thread> m_workers{};
+
+    std::mutex m_mutex{};
+    std::condition_variable m_wake_workers{};
+    std::condition_variable m_tasks_done{};
+
+    // current batch, guarded by m_mutex except for the atomics
+    const std::function<void(int)>* m_task{nullptr};
+    int m_task_count{0};
+    int m_generation{0};
+    int m_busy_workers{0};
+    bool m_quit{false};
+    std::atomic<int> m_next_task{0};
+    std::atomic<int> m_finished_tasks{0};
+
+    void WorkerLoop();
+    void RunTasks(const std::function<void(int)>& task, int task_count);
+};
+
+}  // namespace tanim
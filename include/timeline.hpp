@@ -6,6 +6,8 @@
 #include "tanim/include/timeline_data.hpp"
 #include "tanim/include/user_override.hpp"
 #include "tanim/include/sequencer.hpp"
+#include "tanim/include/profiler.hpp"
+#include "tanim/include/static_bake.hpp"
 
 namespace tanim
 {
@@ -30,9 +32,17 @@ public:
         return tmps;
     }
 
-    static void AddSequence(TimelineData& data) { data.m_sequences.emplace_back(); }
+    static void AddSequence(TimelineData& data)
+    {
+        data.m_sequences.emplace_back();
+        InvalidateBindings(data);
+    }
 
-    static void DeleteSequence(TimelineData& data, int seq_idx) { data.m_sequences.erase(data.m_sequences.begin() + seq_idx); }
+    static void DeleteSequence(TimelineData& data, int seq_idx)
+    {
+        data.m_sequences.erase(data.m_sequences.begin() + seq_idx);
+        InvalidateBindings(data);
+    }
 
     static size_t GetCustomHeight(const TimelineData& data, int index)
     {
@@ -198,6 +208,12 @@ public:
         return helpers::SecondsToSampleTime(cdata.m_player_time, tdata.m_player_samples);
     }
 
+    /// the exact player sample time while playing, the player frame otherwise
+    static float GetSampleTime(const TimelineData& tdata, const ComponentData& cdata)
+    {
+        return GetPlayerPlaying(cdata) ? GetPlayerSampleTime(tdata, cdata) : static_cast<float>(GetPlayerFrame(tdata, cdata));
+    }
+
     static float GetLastFrameRealTime(const TimelineData& data)
     {
         return helpers::FrameToSeconds(data.m_last_frame, data.m_player_samples);
@@ -252,6 +268,7 @@ public:
     {
         cdata.m_player_playing = false;
         ResetPlayerTime(cdata);
+        InvalidateHolds(cdata);
     }
 
     [[nodiscard]] static std::optional<entt::entity> FindEntity(const ComponentData& cdata, const std::string& uid)
@@ -282,6 +299,7 @@ public:
     /// @return has passed last frame
     [[nodiscard]] static bool TickTime(const TimelineData& tdata, ComponentData& cdata, float dt)
     {
+        TANIM_PROFILE_SCOPE(ProfileScope::TICK_TIME);
         cdata.m_player_time += dt;
         if (HasPassedLastFrame(tdata, cdata))
         {
@@ -340,7 +358,43 @@ public:
         return std::nullopt;
     }
 
-    static Sequence& AddSequenceStatic(TimelineData& data) { return data.m_sequences.emplace_back(); }
+    static Sequence& AddSequenceStatic(TimelineData& data)
+    {
+        InvalidateBindings(data);
+        return data.m_sequences.emplace_back();
+    }
+
+    //................<<< Helpers->Bindings >>>...................
+
+    /// every ComponentData playing this timeline rebinds on its next sample
+    static void InvalidateBindings(TimelineData& tdata) { tdata.m_bindings_revision = NextBindingsRevision(); }
+
+    /// this ComponentData rebinds on its next sample. e.g. after its entity hierarchy changed
+    static void InvalidateBindings(ComponentData& cdata) { cdata.m_bound_revision = -1; }
+
+    /// every sequence of this ComponentData is sampled and written again on its next sample
+    static void InvalidateHolds(ComponentData& cdata)
+    {
+        std::fill(cdata.m_holds.begin(), cdata.m_holds.end(), HoldSpan{});
+        cdata.m_statics_applied = false;
+        cdata.m_static_holds = false;
+    }
+
+    /// whether tdata.m_static_sequences and m_dynamic_sequences are up to date, see Tanim::BakeStaticSequences.
+    /// not once a static sequence's curves changed since, until the next bake
+    static bool AreStaticsBaked(const TimelineData& tdata)
+    {
+        return tdata.m_statics_revision == tdata.m_bindings_revision &&
+               std::all_of(tdata.m_static_sequences.begin(),
+                           tdata.m_static_sequences.end(),
+                           [&tdata](int seq_idx) { return IsStaticBakeCurrent(tdata.m_sequences.at(seq_idx)); });
+    }
+
+    static bool IsBound(const TimelineData& tdata, const ComponentData& cdata)
+    {
+        return cdata.m_bound_revision == tdata.m_bindings_revision &&
+               cdata.m_cached_entities.size() == tdata.m_sequences.size();
+    }
 };
 
 }  // namespace tanim
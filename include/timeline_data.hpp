@@ -1,9 +1,26 @@
 #pragma once
 #include "tanim/include/sequence.hpp"
 
+#include <atomic>
+
 namespace tanim
 {
 
+/// a new, process-wide unique TimelineData::m_bindings_revision. never -1, which marks unbound ComponentData
+inline int NextBindingsRevision()
+{
+    static std::atomic<int> revision{0};
+    int next = ++revision;
+    if (next == -1) next = ++revision;
+    return next;
+}
+
+/// writes a sampled value straight into one field of an entity's component, see RegisteredComponent::m_field_writers
+using FieldWriter = void (*)(entt::registry& entt_registry,
+                             entt::entity entity,
+                             RepresentationMeta representation_meta,
+                             const SampledValue& value);
+
 struct TimelineData
 {
     int m_first_frame{0};
@@ -18,6 +35,15 @@ struct TimelineData
     bool m_focused{false};
     bool m_expanded{true};
     int m_selected_sequence{-1};
+    // renewed when sequences are added, removed or re-targeted, invalidating ComponentData bindings. unique across timelines,
+    // so ComponentData bound to one timeline never counts as bound to another
+    int m_bindings_revision{NextBindingsRevision()};
+
+    // filled by Tanim::BakeStaticSequences, only used while m_statics_revision is m_bindings_revision.
+    // static sequences are written once per start, the updates only loop over the dynamic ones
+    std::vector<int> m_static_sequences{};
+    std::vector<int> m_dynamic_sequences{};
+    int m_statics_revision{-1};
 
     TimelineData() : m_sequences({}) {}
 
@@ -43,8 +69,20 @@ struct ComponentData
     float m_player_time{0};
     bool m_player_playing{false};
 
+    // Sequence bindings, filled by Tanim::BindTimeline. One entry per sequence in m_cached_entities and m_cached_writers, a
+    // nullptr writer for a sequence without a registered component and field. Register all components before binding.
     std::vector<EntityData> m_cached_entities_data;
     std::vector<entt::entity> m_cached_entities;
+    std::vector<FieldWriter> m_cached_writers;
+    int m_bound_revision{-1};  // TimelineData::m_bindings_revision these bindings were made for. -1 = unbound
+
+    // per sequence: the times its last written value holds for, see FindSequenceHold. Playback skips sampling and writing a
+    // sequence while its sample time stays inside. Emptied on binding, StartTimeline, Stop and Tanim::InvalidateHolds.
+    std::vector<HoldSpan> m_holds;
+    // per sequence: Sequence::GetCurveRevisions when its hold was found. an edit of the curves ends the hold
+    std::vector<std::array<uint32_t, 5>> m_hold_revisions;
+    bool m_statics_applied{false};  // every static sequence was written since then, see TimelineData::m_static_sequences
+    bool m_static_holds{false};     // m_holds may hold static sequences forever, emptied once the statics are no longer baked
 };
 
 }  // namespace tanim
@@ -0,0 +1,67 @@
+#include "tanim/include/alloc_tracking.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace tanim
+{
+
+namespace
+{
+
+// constant-initialized, so operator new can use it on any thread without a dynamic TLS initializer
+thread_local int64_t t_allocation_count{0};
+
+}  // namespace
+
+int64_t GetAllocationCount() { return t_allocation_count; }
+
+}  // namespace tanim
+
+#ifdef TANIM_TRACK_ALLOCATIONS
+
+// the counting replacements of the global operator new / delete. the over-aligned forms keep their default, uncounted
+// implementation: nothing in tanim asks for more than the default alignment
+
+namespace
+{
+
+void* CountedAllocate(std::size_t size) noexcept
+{
+    ++tanim::t_allocation_count;
+    return std::malloc(size > 0 ? size : 1);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+    void* ptr = CountedAllocate(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    void* ptr = CountedAllocate(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+#endif
@@ -0,0 +1,729 @@
+#include "tanim/include/baked_timeline.hpp"
+
+#include "tanim/include/tanim.hpp"
+#include "tanim/include/binary_io.hpp"
+#include "tanim/include/bezier.hpp"
+#include "tanim/include/registry.hpp"
+#include "tanim/include/sequencer.hpp"
+#include "tanim/include/user_override.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tanim
+{
+
+/*
+ * Tanim baked timeline, read in place by MappedTimeline:
+ *     BakedHeader | BakedSequenceRecord[] | BakedCurveRecord[] | string blob |
+ *     per curve: times, values, segments (FLOAT) or QuantizedRange, QuantizedKeys (QUANTIZED)
+ * every table and array starts 4-byte aligned. the float arrays, CompiledSegments and quantized keys are stored in their
+ * in-memory layout, so the format is only produced and read on little-endian hosts.
+ *
+ * version history:
+ * 1:
+ *     initial version
+ *     CompiledSegment::m_analytic was added later in what was a zero padding byte, so older files play with Newton-Raphson
+ * 2:
+ *     BakedCurveRecord::m_encoding and m_quantized_offset, for quantized curves. version 1 files must be baked again
+ *     CompiledSegment::m_level and kQuantizedLevel were added later in what were zero padding bits, so older files sample
+ *     level segments with Bezier math
+ */
+
+namespace
+{
+
+constexpr std::string_view kBakedMagic{"TANR"};
+constexpr uint32_t kBakedVersion = 2;
+
+static_assert(std::endian::native == std::endian::little, "baked timelines are read in place, which needs a little-endian host");
+static_assert(sizeof(BakedHeader) == 72 && sizeof(BakedSequenceRecord) == 56 && sizeof(BakedCurveRecord) == 32);
+static_assert(sizeof(CompiledSegment) == 36 && offsetof(CompiledSegment, m_constant) == 32 &&
+              offsetof(CompiledSegment, m_flat) == 33 && offsetof(CompiledSegment, m_analytic) == 34 &&
+              offsetof(CompiledSegment, m_level) == 35);
+static_assert(sizeof(QuantizedRange) == 16 && sizeof(QuantizedKey) == 16 && offsetof(QuantizedKey, m_value) == 4 &&
+              offsetof(QuantizedKey, m_flags) == 14);
+
+void WriteStringRef(BinaryWriter& writer, const std::vector<uint32_t>& string_offsets, StringTable& strings, const std::string& str)
+{
+    writer.WriteU32(string_offsets.at(strings.Intern(str)));
+    writer.WriteU32(static_cast<uint32_t>(str.size()));
+}
+
+uint32_t AlignUp(uint32_t value) { return (value + 3u) & ~3u; }
+
+uint32_t GetFloatCurveSize(const RuntimeCurve& runtime)
+{
+    return static_cast<uint32_t>(runtime.m_times.size() * 2 * sizeof(float) + runtime.m_segments.size() * sizeof(CompiledSegment));
+}
+
+uint32_t GetQuantizedCurveSize(const QuantizedCurve& quantized)
+{
+    return static_cast<uint32_t>(sizeof(QuantizedRange) + quantized.m_keys.size() * sizeof(QuantizedKey));
+}
+
+template <typename EnumType>
+bool IsValidEnum(uint32_t value)
+{
+    return value <= 0xFF && magic_enum::enum_cast<EnumType>(static_cast<uint8_t>(value)).has_value();
+}
+
+}  // namespace
+
+// === Baking ===
+
+std::vector<uint8_t> Tanim::SerializeBaked(const TimelineData& tdata, const QuantizeSettings& quantize, QuantizeReport* report)
+{
+    StringTable strings{};
+    strings.Intern(tdata.m_name);
+    uint32_t curve_total = 0;
+    for (const auto& seq : tdata.m_sequences)
+    {
+        strings.Intern(seq.m_seq_id.GetEntityData().m_uid);
+        strings.Intern(seq.m_seq_id.GetEntityData().m_display);
+        strings.Intern(seq.m_seq_id.StructName());
+        strings.Intern(seq.m_seq_id.FieldName());
+        for (const auto& curve : seq.m_curves) strings.Intern(curve.m_name);
+        curve_total += static_cast<uint32_t>(seq.m_curves.size());
+    }
+
+    std::vector<uint32_t> string_offsets{};
+    uint32_t strings_size = 0;
+    for (const auto& str : strings.GetStrings())
+    {
+        string_offsets.push_back(strings_size);
+        strings_size += static_cast<uint32_t>(str.size());
+    }
+
+    // === Layout ===
+    const uint32_t sequence_count = static_cast<uint32_t>(tdata.m_sequences.size());
+    const uint32_t sequences_offset = sizeof(BakedHeader);
+    const uint32_t curves_offset = sequences_offset + sequence_count * sizeof(BakedSequenceRecord);
+    const uint32_t strings_offset = curves_offset + curve_total * sizeof(BakedCurveRecord);
+    uint32_t data_offset = AlignUp(strings_offset + strings_size);
+
+    // === Quantization ===
+    // quaternion playback reads the float segments of its curves, so those always stay float
+    std::vector<std::optional<QuantizedCurve>> quantized_curves{};
+    quantized_curves.reserve(curve_total);
+    if (report) *report = {};
+    for (int seq_idx = 0; seq_idx < static_cast<int>(tdata.m_sequences.size()); ++seq_idx)
+    {
+        const Sequence& seq = tdata.m_sequences.at(seq_idx);
+        for (int curve_idx = 0; curve_idx < static_cast<int>(seq.m_curves.size()); ++curve_idx)
+        {
+            const RuntimeCurve& runtime = seq.m_curves.at(curve_idx).m_runtime;
+            std::optional<QuantizedCurve>& quantized = quantized_curves.emplace_back();
+
+            CurveQuantizeReport curve_report{};
+            curve_report.m_seq_idx = seq_idx;
+            curve_report.m_curve_idx = curve_idx;
+            if (quantize.m_enabled && seq.m_representation_meta != RepresentationMeta::QUAT && CanQuantizeCurve(runtime))
+            {
+                QuantizedCurve candidate = QuantizeCurve(runtime);
+                curve_report.m_max_error = MeasureQuantizeError(candidate, runtime, quantize.m_samples_per_segment);
+                if (curve_report.m_max_error <= quantize.m_max_error)
+                {
+                    curve_report.m_quantized = true;
+                    quantized = std::move(candidate);
+                }
+            }
+
+            if (report)
+            {
+                if (curve_report.m_quantized)
+                {
+                    report->m_curves_quantized++;
+                    report->m_bytes_saved += GetFloatCurveSize(runtime) - GetQuantizedCurveSize(quantized.value());
+                    report->m_max_error = std::max(report->m_max_error, curve_report.m_max_error);
+                }
+                else
+                {
+                    report->m_curves_float++;
+                }
+                report->m_curves.push_back(curve_report);
+            }
+        }
+    }
+
+    std::vector<BakedCurveRecord> curve_records{};
+    curve_records.reserve(curve_total);
+    for (const auto& seq : tdata.m_sequences)
+    {
+        for (const auto& curve : seq.m_curves)
+        {
+            BakedCurveRecord& record = curve_records.emplace_back();
+            record.m_keyframe_count = static_cast<uint32_t>(curve.m_runtime.m_times.size());
+
+            if (const auto& quantized = quantized_curves.at(curve_records.size() - 1); quantized.has_value())
+            {
+                record.m_encoding = static_cast<uint32_t>(BakedCurveEncoding::QUANTIZED);
+                record.m_quantized_offset = data_offset;
+                data_offset += GetQuantizedCurveSize(quantized.value());
+                continue;
+            }
+
+            record.m_encoding = static_cast<uint32_t>(BakedCurveEncoding::FLOAT);
+            record.m_times_offset = data_offset;
+            data_offset += record.m_keyframe_count * sizeof(float);
+            record.m_values_offset = data_offset;
+            data_offset += record.m_keyframe_count * sizeof(float);
+            record.m_segments_offset = data_offset;
+            data_offset += static_cast<uint32_t>(curve.m_runtime.m_segments.size() * sizeof(CompiledSegment));
+        }
+    }
+
+    BinaryWriter writer{};
+
+    // === Header ===
+    writer.WriteBytes(kBakedMagic);
+    writer.WriteU32(kBakedVersion);
+    writer.WriteU32(data_offset);  // file size
+    writer.WriteU32(strings_offset);
+    writer.WriteU32(strings_size);
+    writer.WriteU32(sequences_offset);
+    writer.WriteU32(sequence_count);
+    writer.WriteU32(curves_offset);
+    writer.WriteU32(curve_total);
+    WriteStringRef(writer, string_offsets, strings, tdata.m_name);
+    writer.WriteI32(tdata.m_first_frame);
+    writer.WriteI32(tdata.m_last_frame);
+    writer.WriteI32(tdata.m_min_frame);
+    writer.WriteI32(tdata.m_max_frame);
+    writer.WriteU32(tdata.m_play_immediately ? 1 : 0);
+    writer.WriteI32(tdata.m_player_samples);
+    writer.WriteU32(static_cast<uint32_t>(tdata.m_playback_type));
+
+    // === Sequence Records ===
+    uint32_t first_curve = 0;
+    for (const auto& seq : tdata.m_sequences)
+    {
+        WriteStringRef(writer, string_offsets, strings, seq.m_seq_id.GetEntityData().m_uid);
+        WriteStringRef(writer, string_offsets, strings, seq.m_seq_id.GetEntityData().m_display);
+        WriteStringRef(writer, string_offsets, strings, seq.m_seq_id.StructName());
+        WriteStringRef(writer, string_offsets, strings, seq.m_seq_id.FieldName());
+        writer.WriteU32(static_cast<uint32_t>(seq.m_type_meta));
+        writer.WriteU32(static_cast<uint32_t>(seq.m_representation_meta));
+        writer.WriteI32(seq.m_first_frame);
+        writer.WriteI32(seq.m_last_frame);
+        writer.WriteU32(first_curve);
+        writer.WriteU32(static_cast<uint32_t>(seq.m_curves.size()));
+        first_curve += static_cast<uint32_t>(seq.m_curves.size());
+    }
+
+    // === Curve Records ===
+    int curve_idx = 0;
+    for (const auto& seq : tdata.m_sequences)
+    {
+        for (const auto& curve : seq.m_curves)
+        {
+            const BakedCurveRecord& record = curve_records.at(curve_idx++);
+            WriteStringRef(writer, string_offsets, strings, curve.m_name);
+            writer.WriteU32(record.m_keyframe_count);
+            writer.WriteU32(record.m_encoding);
+            writer.WriteU32(record.m_times_offset);
+            writer.WriteU32(record.m_values_offset);
+            writer.WriteU32(record.m_segments_offset);
+            writer.WriteU32(record.m_quantized_offset);
+        }
+    }
+
+    // === String Blob ===
+    for (const auto& str : strings.GetStrings()) writer.WriteBytes(str);
+    writer.AlignTo(4);
+
+    // === Curve Data ===
+    curve_idx = 0;
+    for (const auto& seq : tdata.m_sequences)
+    {
+        for (const auto& curve : seq.m_curves)
+        {
+            if (const auto& quantized = quantized_curves.at(curve_idx++); quantized.has_value())
+            {
+                const QuantizedRange& range = quantized->m_range;
+                writer.WriteF32(range.m_value_min);
+                writer.WriteF32(range.m_value_step);
+                writer.WriteF32(range.m_offset_min);
+                writer.WriteF32(range.m_offset_step);
+                for (const auto& key : quantized->m_keys)
+                {
+                    writer.WriteI32(key.m_frame);
+                    writer.WriteU16(key.m_value);
+                    writer.WriteU16(key.m_in_x);
+                    writer.WriteU16(key.m_in_y);
+                    writer.WriteU16(key.m_out_x);
+                    writer.WriteU16(key.m_out_y);
+                    writer.WriteU8(key.m_flags);
+                    writer.WriteU8(0);
+                }
+                continue;
+            }
+
+            const RuntimeCurve& runtime = curve.m_runtime;
+            for (const float time : runtime.m_times) writer.WriteF32(time);
+            for (const float value : runtime.m_values) writer.WriteF32(value);
+            for (const auto& segment : runtime.m_segments)
+            {
+                for (const float c : segment.m_x) writer.WriteF32(c);
+                for (const float c : segment.m_y) writer.WriteF32(c);
+                writer.WriteBool(segment.m_constant);
+                writer.WriteBool(segment.m_flat);
+                writer.WriteBool(segment.m_analytic);
+                writer.WriteBool(segment.m_level);
+                writer.AlignTo(4);
+            }
+        }
+    }
+
+    assert(writer.GetSize() == data_offset);
+    return std::move(writer.GetBytes());
+}
+
+// === MappedTimeline ===
+
+MappedTimeline::~MappedTimeline() { Close(); }
+
+MappedTimeline::MappedTimeline(MappedTimeline&& other) noexcept { *this = std::move(other); }
+
+MappedTimeline& MappedTimeline::operator=(MappedTimeline&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        m_bytes = std::exchange(other.m_bytes, {});
+        m_header = std::exchange(other.m_header, nullptr);
+        m_sequences = std::exchange(other.m_sequences, nullptr);
+        m_curves = std::exchange(other.m_curves, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+        m_mapping_size = std::exchange(other.m_mapping_size, 0);
+        m_file_handle = std::exchange(other.m_file_handle, nullptr);
+        m_mapping_handle = std::exchange(other.m_mapping_handle, nullptr);
+        m_timeline_data = std::move(other.m_timeline_data);
+        m_field_indices = std::move(other.m_field_indices);
+        m_quat_tracks = std::move(other.m_quat_tracks);
+    }
+    return *this;
+}
+
+bool MappedTimeline::Open(const std::string& path)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        LogError("Couldn't open baked timeline " + path);
+        return false;
+    }
+    m_file_handle = file;
+
+    LARGE_INTEGER file_size{};
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+    {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    m_mapping_handle = mapping;
+    m_mapping = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    m_mapping_size = static_cast<size_t>(file_size.QuadPart);
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        LogError("Couldn't open baked timeline " + path);
+        return false;
+    }
+
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+    {
+        void* mapping = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            m_mapping = mapping;
+            m_mapping_size = static_cast<size_t>(file_stat.st_size);
+        }
+    }
+    close(fd);  // the mapping stays valid without the descriptor
+#endif
+
+    if (m_mapping == nullptr)
+    {
+        LogError("Couldn't map baked timeline " + path);
+        Unmap();
+        return false;
+    }
+
+    m_bytes = {static_cast<const uint8_t*>(m_mapping), m_mapping_size};
+    if (!Validate())
+    {
+        LogError("Invalid baked timeline " + path);
+        Close();
+        return false;
+    }
+
+    Adopt();
+    return true;
+}
+
+bool MappedTimeline::View(std::span<const uint8_t> bytes)
+{
+    Close();
+
+    m_bytes = bytes;
+    if (!Validate())
+    {
+        LogError("Invalid baked timeline data");
+        m_bytes = {};
+        return false;
+    }
+
+    Adopt();
+    return true;
+}
+
+void MappedTimeline::Close()
+{
+    Unmap();
+    m_bytes = {};
+    m_header = nullptr;
+    m_sequences = nullptr;
+    m_curves = nullptr;
+    m_field_indices.clear();
+    m_quat_tracks.clear();
+}
+
+void MappedTimeline::Unmap()
+{
+#ifdef _WIN32
+    if (m_mapping) UnmapViewOfFile(m_mapping);
+    if (m_mapping_handle) CloseHandle(m_mapping_handle);
+    if (m_file_handle) CloseHandle(m_file_handle);
+#else
+    if (m_mapping) munmap(const_cast<void*>(m_mapping), m_mapping_size);
+#endif
+    m_mapping = nullptr;
+    m_mapping_size = 0;
+    m_file_handle = nullptr;
+    m_mapping_handle = nullptr;
+}
+
+bool MappedTimeline::Validate() const
+{
+    const uint64_t size = m_bytes.size();
+    if (size < sizeof(BakedHeader)) return false;
+    if (reinterpret_cast<uintptr_t>(m_bytes.data()) % alignof(BakedHeader) != 0) return false;
+
+    const auto* header = reinterpret_cast<const BakedHeader*>(m_bytes.data());
+    if (std::string_view(header->m_magic, 4) != kBakedMagic) return false;
+    if (header->m_version != kBakedVersion || header->m_file_size != size) return false;
+
+    auto is_table = [size](uint64_t offset, uint64_t count, uint64_t stride)
+    { return offset % 4 == 0 && offset + count * stride <= size; };
+    auto is_string = [header](const BakedStringRef& ref)
+    { return static_cast<uint64_t>(ref.m_offset) + ref.m_length <= header->m_strings_size; };
+
+    if (!is_table(header->m_sequences_offset, header->m_sequence_count, sizeof(BakedSequenceRecord))) return false;
+    if (!is_table(header->m_curves_offset, header->m_curve_count, sizeof(BakedCurveRecord))) return false;
+    if (static_cast<uint64_t>(header->m_strings_offset) + header->m_strings_size > size) return false;
+    if (!is_string(header->m_name)) return false;
+    if (!IsValidEnum<PlaybackType>(header->m_playback_type)) return false;
+
+    const auto* curves = reinterpret_cast<const BakedCurveRecord*>(m_bytes.data() + header->m_curves_offset);
+    for (uint32_t curve_idx = 0; curve_idx < header->m_curve_count; ++curve_idx)
+    {
+        const BakedCurveRecord& curve = curves[curve_idx];
+        const uint32_t segment_count = curve.m_keyframe_count > 0 ? curve.m_keyframe_count - 1 : 0;
+        if (!is_string(curve.m_name)) return false;
+        if (!IsValidEnum<BakedCurveEncoding>(curve.m_encoding)) return false;
+        if (static_cast<BakedCurveEncoding>(curve.m_encoding) == BakedCurveEncoding::QUANTIZED)
+        {
+            if (!is_table(curve.m_quantized_offset, 1, sizeof(QuantizedRange))) return false;
+            const uint64_t keys_offset = static_cast<uint64_t>(curve.m_quantized_offset) + sizeof(QuantizedRange);
+            if (!is_table(keys_offset, curve.m_keyframe_count, sizeof(QuantizedKey))) return false;
+            continue;
+        }
+        if (!is_table(curve.m_times_offset, curve.m_keyframe_count, sizeof(float))) return false;
+        if (!is_table(curve.m_values_offset, curve.m_keyframe_count, sizeof(float))) return false;
+        if (!is_table(curve.m_segments_offset, segment_count, sizeof(CompiledSegment))) return false;
+
+        // the flags at offsets 32 to 35 are read in place as bool, so anything but 0 or 1 is rejected
+        const uint8_t* segments = m_bytes.data() + curve.m_segments_offset;
+        for (uint32_t segment_idx = 0; segment_idx < segment_count; ++segment_idx)
+        {
+            const uint8_t* flags = segments + segment_idx * sizeof(CompiledSegment) + offsetof(CompiledSegment, m_constant);
+            if (std::any_of(flags, flags + 4, [](uint8_t flag) { return flag > 1; })) return false;
+        }
+    }
+
+    const auto* sequences = reinterpret_cast<const BakedSequenceRecord*>(m_bytes.data() + header->m_sequences_offset);
+    for (uint32_t seq_idx = 0; seq_idx < header->m_sequence_count; ++seq_idx)
+    {
+        const BakedSequenceRecord& seq = sequences[seq_idx];
+        if (!is_string(seq.m_uid) || !is_string(seq.m_display) || !is_string(seq.m_struct_name) || !is_string(seq.m_field_name))
+        {
+            return false;
+        }
+        if (static_cast<uint64_t>(seq.m_first_curve) + seq.m_curve_count > header->m_curve_count) return false;
+        if (!IsValidEnum<Sequence::TypeMeta>(seq.m_type_meta)) return false;
+        if (!IsValidEnum<RepresentationMeta>(seq.m_representation_meta)) return false;
+
+        // quaternion playback indexes the X, Y, Z and spins curves with the segments of W, all of them float
+        if (static_cast<RepresentationMeta>(seq.m_representation_meta) == RepresentationMeta::QUAT)
+        {
+            if (seq.m_curve_count < 5) return false;
+            for (uint32_t curve_idx = 0; curve_idx < 5; ++curve_idx)
+            {
+                const BakedCurveRecord& curve = curves[seq.m_first_curve + curve_idx];
+                if (curve.m_keyframe_count != curves[seq.m_first_curve].m_keyframe_count) return false;
+                if (static_cast<BakedCurveEncoding>(curve.m_encoding) != BakedCurveEncoding::FLOAT) return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void MappedTimeline::Adopt()
+{
+    m_header = reinterpret_cast<const BakedHeader*>(m_bytes.data());
+    m_sequences = reinterpret_cast<const BakedSequenceRecord*>(m_bytes.data() + m_header->m_sequences_offset);
+    m_curves = reinterpret_cast<const BakedCurveRecord*>(m_bytes.data() + m_header->m_curves_offset);
+
+    m_timeline_data.m_name = GetString(m_header->m_name);
+    m_timeline_data.m_first_frame = m_header->m_first_frame;
+    m_timeline_data.m_last_frame = m_header->m_last_frame;
+    m_timeline_data.m_min_frame = m_header->m_min_frame;
+    m_timeline_data.m_max_frame = m_header->m_max_frame;
+    m_timeline_data.m_play_immediately = m_header->m_play_immediately != 0;
+    m_timeline_data.m_player_samples = m_header->m_player_samples;
+    m_timeline_data.m_playback_type = static_cast<PlaybackType>(m_header->m_playback_type);
+    m_timeline_data.m_sequences.clear();
+    Timeline::InvalidateBindings(m_timeline_data);
+
+    m_field_indices.assign(m_header->m_sequence_count, -1);
+
+    m_quat_tracks.assign(m_header->m_sequence_count, QuatTrack{});
+    for (int seq_idx = 0; seq_idx < GetSequenceCount(); ++seq_idx)
+    {
+        if (static_cast<RepresentationMeta>(m_sequences[seq_idx].m_representation_meta) == RepresentationMeta::QUAT)
+        {
+            m_quat_tracks.at(seq_idx) = CompileQuatTrack(GetCurve(seq_idx, 0),
+                                                         GetCurve(seq_idx, 1),
+                                                         GetCurve(seq_idx, 2),
+                                                         GetCurve(seq_idx, 3),
+                                                         GetCurve(seq_idx, 4));
+        }
+    }
+}
+
+std::string_view MappedTimeline::GetString(const BakedStringRef& ref) const
+{
+    return {reinterpret_cast<const char*>(m_bytes.data()) + m_header->m_strings_offset + ref.m_offset, ref.m_length};
+}
+
+MappedSequence MappedTimeline::GetSequence(int seq_idx) const
+{
+    assert(seq_idx >= 0 && seq_idx < GetSequenceCount());
+    const BakedSequenceRecord& record = m_sequences[seq_idx];
+
+    MappedSequence seq{};
+    seq.m_uid = GetString(record.m_uid);
+    seq.m_display = GetString(record.m_display);
+    seq.m_struct_name = GetString(record.m_struct_name);
+    seq.m_field_name = GetString(record.m_field_name);
+    seq.m_type_meta = static_cast<Sequence::TypeMeta>(record.m_type_meta);
+    seq.m_representation_meta = static_cast<RepresentationMeta>(record.m_representation_meta);
+    seq.m_first_frame = record.m_first_frame;
+    seq.m_last_frame = record.m_last_frame;
+    seq.m_curve_count = static_cast<int>(record.m_curve_count);
+    return seq;
+}
+
+const BakedCurveRecord& MappedTimeline::GetCurveRecord(int seq_idx, int curve_idx) const
+{
+    assert(seq_idx >= 0 && seq_idx < GetSequenceCount());
+    assert(curve_idx >= 0 && curve_idx < static_cast<int>(m_sequences[seq_idx].m_curve_count));
+    return m_curves[m_sequences[seq_idx].m_first_curve + curve_idx];
+}
+
+bool MappedTimeline::IsCurveQuantized(int seq_idx, int curve_idx) const
+{
+    return static_cast<BakedCurveEncoding>(GetCurveRecord(seq_idx, curve_idx).m_encoding) == BakedCurveEncoding::QUANTIZED;
+}
+
+RuntimeCurveView MappedTimeline::GetCurve(int seq_idx, int curve_idx) const
+{
+    assert(!IsCurveQuantized(seq_idx, curve_idx));
+    const BakedCurveRecord& record = GetCurveRecord(seq_idx, curve_idx);
+
+    const uint32_t keyframe_count = record.m_keyframe_count;
+    const uint32_t segment_count = keyframe_count > 0 ? keyframe_count - 1 : 0;
+    return {{reinterpret_cast<const float*>(m_bytes.data() + record.m_times_offset), keyframe_count},
+            {reinterpret_cast<const float*>(m_bytes.data() + record.m_values_offset), keyframe_count},
+            {reinterpret_cast<const CompiledSegment*>(m_bytes.data() + record.m_segments_offset), segment_count}};
+}
+
+QuantizedCurveView MappedTimeline::GetQuantizedCurve(int seq_idx, int curve_idx) const
+{
+    assert(IsCurveQuantized(seq_idx, curve_idx));
+    const BakedCurveRecord& record = GetCurveRecord(seq_idx, curve_idx);
+
+    const uint8_t* data = m_bytes.data() + record.m_quantized_offset;
+    return {*reinterpret_cast<const QuantizedRange*>(data),
+            {reinterpret_cast<const QuantizedKey*>(data + sizeof(QuantizedRange)), record.m_keyframe_count}};
+}
+
+SampledValue MappedTimeline::Evaluate(int seq_idx, float sample_time) const
+{
+    TANIM_PROFILE_COUNT(ProfileCounter::SEQUENCES_SAMPLED, 1);
+
+    const BakedSequenceRecord& record = m_sequences[seq_idx];
+
+    SampledValue value{};
+    if (static_cast<RepresentationMeta>(record.m_representation_meta) == RepresentationMeta::QUAT)
+    {
+        const glm::quat q = SampleQuatTrack(m_quat_tracks.at(seq_idx), sample_time);
+        value = {q.w, q.x, q.y, q.z};
+    }
+    else
+    {
+        const int curve_count = std::min(static_cast<int>(record.m_curve_count), static_cast<int>(value.size()));
+        for (int curve_idx = 0; curve_idx < curve_count; ++curve_idx)
+        {
+            value.at(curve_idx) = IsCurveQuantized(seq_idx, curve_idx)
+                                      ? SampleQuantizedCurve(GetQuantizedCurve(seq_idx, curve_idx), sample_time)
+                                      : SampleRuntimeCurve(GetCurve(seq_idx, curve_idx), sample_time);
+        }
+    }
+    return value;
+}
+
+HoldSpan MappedTimeline::FindHold(int seq_idx, float sample_time) const
+{
+    const BakedSequenceRecord& record = m_sequences[seq_idx];
+
+    if (static_cast<RepresentationMeta>(record.m_representation_meta) == RepresentationMeta::QUAT)
+    {
+        int cursor = -1;
+        return sequencer::FindQuatHold(GetCurve(seq_idx, 0),
+                                       GetCurve(seq_idx, 1),
+                                       GetCurve(seq_idx, 2),
+                                       GetCurve(seq_idx, 3),
+                                       GetCurve(seq_idx, 4),
+                                       sample_time,
+                                       cursor);
+    }
+
+    HoldSpan hold{-std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()};
+    const int curve_count = std::min(static_cast<int>(record.m_curve_count), static_cast<int>(SampledValue{}.size()));
+    for (int curve_idx = 0; curve_idx < curve_count && hold.m_begin < hold.m_end; ++curve_idx)
+    {
+        const HoldSpan curve_hold = IsCurveQuantized(seq_idx, curve_idx)
+                                        ? FindQuantizedHold(GetQuantizedCurve(seq_idx, curve_idx), sample_time)
+                                        : FindRuntimeHold(GetCurve(seq_idx, curve_idx), sample_time);
+        hold = {std::max(hold.m_begin, curve_hold.m_begin), std::min(hold.m_end, curve_hold.m_end)};
+    }
+    return hold.m_begin < hold.m_end ? hold : HoldSpan{};
+}
+
+// === Playback ===
+
+void Tanim::BindMappedTimeline(MappedTimeline& mapped, ComponentData& cdata)
+{
+    const int seq_count = mapped.GetSequenceCount();
+    cdata.m_cached_entities.assign(seq_count, entt::null);
+    cdata.m_cached_writers.assign(seq_count, nullptr);
+    cdata.m_holds.assign(seq_count, HoldSpan{});
+
+    std::vector<int>& field_indices = mapped.GetFieldIndices();
+    for (int seq_idx = 0; seq_idx < seq_count; ++seq_idx)
+    {
+        const MappedSequence seq = mapped.GetSequence(seq_idx);
+
+        const RegisteredComponent* comp = nullptr;
+        for (const auto& component : GetRegistry().GetComponents())
+        {
+            if (component.m_struct_name == seq.m_struct_name)
+            {
+                field_indices.at(seq_idx) = component.FindFieldIndex(std::string(seq.m_field_name));
+                comp = &component;
+                break;
+            }
+        }
+
+        if (comp == nullptr || field_indices.at(seq_idx) < 0)
+        {
+            LogError("Couldn't find any registered component with matching details: " + std::string(seq.m_struct_name) +
+                     "::" + std::string(seq.m_field_name));
+            continue;
+        }
+
+        cdata.m_cached_writers.at(seq_idx) = comp->GetFieldWriter(field_indices.at(seq_idx));
+        cdata.m_cached_entities.at(seq_idx) = Timeline::FindEntity(cdata, std::string(seq.m_uid)).value_or(entt::null);
+    }
+
+    cdata.m_bound_revision = mapped.GetTimelineData().m_bindings_revision;
+}
+
+void Tanim::UpdateMappedTimeline(entt::registry& registry, MappedTimeline& mapped, ComponentData& cdata, float delta_time)
+{
+    if (!mapped.IsOpen() || !Timeline::GetPlayerPlaying(cdata)) return;
+
+    const AllocationScope allocations{};
+    const TimelineData& tdata = mapped.GetTimelineData();
+    TANIM_PROFILE_TIMELINE(tdata);
+    const int seq_count = mapped.GetSequenceCount();
+    const bool was_bound =
+        cdata.m_bound_revision == tdata.m_bindings_revision && static_cast<int>(cdata.m_cached_entities.size()) == seq_count;
+    if (!was_bound)
+    {
+        BindMappedTimeline(mapped, cdata);
+    }
+
+    const bool has_passed_last_frame = Timeline::TickTime(tdata, cdata, delta_time);
+    const int player_frame = Timeline::GetPlayerFrame(tdata, cdata);
+    const float sample_time = Timeline::GetSampleTime(tdata, cdata);
+
+    const bool skip_held = SkipsHeldSequences(tdata);
+    TANIM_PROFILE_SCOPE(ProfileScope::SAMPLE);
+    for (int seq_idx = 0; seq_idx < seq_count; ++seq_idx)
+    {
+        const MappedSequence seq = mapped.GetSequence(seq_idx);
+        const FieldWriter write = cdata.m_cached_writers.at(seq_idx);
+        const entt::entity entity = cdata.m_cached_entities.at(seq_idx);
+        HoldSpan& hold = cdata.m_holds.at(seq_idx);
+        const bool held = skip_held && hold.Contains(sample_time);
+        if (held) TANIM_PROFILE_COUNT(ProfileCounter::WRITES_SKIPPED, 1);
+        if (write && entity != entt::null && seq.IsBetweenFirstAndLastFrame(player_frame) && !held)
+        {
+            write(registry, entity, seq.m_representation_meta, mapped.Evaluate(seq_idx, sample_time));
+            hold = skip_held ? mapped.FindHold(seq_idx, sample_time) : HoldSpan{};
+        }
+    }
+
+    Timeline::CheckLooping(tdata, cdata, has_passed_last_frame);
+    RecordUpdateAllocations(tdata, allocations.GetCount(), was_bound);
+}
+
+}  // namespace tanim
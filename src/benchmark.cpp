@@ -0,0 +1,288 @@
+#include "tanim/include/benchmark.hpp"
+
+#include "tanim/include/bezier.hpp"
+#include "tanim/include/curve_functions.hpp"
+#include "tanim/include/sequence.hpp"
+#include "tanim/include/sequencer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <utility>
+
+namespace tanim
+{
+
+namespace
+{
+
+// results are stored here, so the timed calls can't be optimized away
+volatile float g_benchmark_sink = 0.0f;
+
+// repeats batch (which returns the operations it did) for m_min_run_seconds, m_repetitions times
+template <typename Batch>
+BenchmarkResult TimeBenchmark(const BenchmarkSettings& settings,
+                              std::string name,
+                              CurveHandleType handle_type,
+                              int keyframe_count,
+                              Batch&& batch)
+{
+    using Clock = std::chrono::steady_clock;
+
+    BenchmarkResult result{std::move(name), handle_type, keyframe_count};
+    std::vector<double> ns_per_op{};
+    for (int rep = 0; rep < std::max(settings.m_repetitions, 1); ++rep)
+    {
+        int64_t operations = 0;
+        double elapsed_ns = 0.0;
+        const auto start = Clock::now();
+        do
+        {
+            operations += batch();
+            elapsed_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        } while (elapsed_ns < settings.m_min_run_seconds * 1e9);
+
+        ns_per_op.push_back(elapsed_ns / static_cast<double>(std::max<int64_t>(operations, 1)));
+        result.m_operations += operations;
+    }
+
+    std::sort(ns_per_op.begin(), ns_per_op.end());
+    result.m_ns_per_op = ns_per_op.at(ns_per_op.size() / 2);
+    result.m_ns_per_op_best = ns_per_op.front();
+    return result;
+}
+
+// keyframes on frames 0 .. count - 1 with random values, handle_type locked
+Curve MakeBenchmarkCurve(int count, CurveHandleType handle_type, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::vector<std::pair<float, float>> keys{};
+    keys.reserve(count);
+    for (int k = 0; k < count; ++k) keys.emplace_back(static_cast<float>(k), value(rng));
+
+    Curve curve{};
+    SetCurveHandleType(curve, handle_type);
+    LockCurveHandleType(curve);
+    AddKeyframes(curve, keys);
+    return curve;
+}
+
+// random unit quaternions on frames 0 .. count - 1, curves set up like reflection::AddSequence does.
+// W gets handle_type, as it decides CONSTANT and FLAT segments of the quaternion
+Sequence MakeBenchmarkQuatSequence(int count, CurveHandleType handle_type, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::vector<std::pair<float, float>> keys[5]{};
+    for (int k = 0; k < count; ++k)
+    {
+        const glm::quat q = glm::normalize(glm::quat(value(rng), value(rng), value(rng), value(rng)));
+        const float frame = static_cast<float>(k);
+        keys[0].emplace_back(frame, q.w);
+        keys[1].emplace_back(frame, q.x);
+        keys[2].emplace_back(frame, q.y);
+        keys[3].emplace_back(frame, q.z);
+        keys[4].emplace_back(frame, 0.0f);
+    }
+
+    Sequence seq{};
+    seq.m_representation_meta = RepresentationMeta::QUAT;
+    const char* names[5]{"W", "X", "Y", "Z", "Spins"};
+    for (int curve_idx = 0; curve_idx < 5; ++curve_idx)
+    {
+        Curve& curve = seq.AddCurve();
+        curve.m_name = names[curve_idx];
+        SetCurveHandleType(curve,
+                           curve_idx == 0   ? handle_type
+                           : curve_idx == 4 ? CurveHandleType::CONSTANT
+                                            : CurveHandleType::LINEAR);
+        LockCurveHandleType(curve);
+        AddKeyframes(curve, keys[curve_idx]);
+    }
+    sequencer::UpdateQuatTrack(seq);
+    return seq;
+}
+
+// settings.m_samples random times over [0, count - 1]
+std::vector<float> MakeSampleTimes(const BenchmarkSettings& settings, int count, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> time(0.0f, static_cast<float>(std::max(count - 1, 1)));
+    std::vector<float> times(std::max(settings.m_samples, 1));
+    for (float& t : times) t = time(rng);
+    return times;
+}
+
+void RunBenchmarksOf(const BenchmarkSettings& settings, int count, CurveHandleType handle_type, BenchmarkReport& report)
+{
+    std::mt19937 rng(settings.m_seed);
+    auto& results = report.m_results;
+
+    Curve curve = MakeBenchmarkCurve(count, handle_type, rng);
+    const std::vector<float> times = MakeSampleTimes(settings, count, rng);
+    const auto samples = static_cast<int64_t>(times.size());
+
+    results.push_back(TimeBenchmark(settings,
+                                    "SampleCurveValue",
+                                    handle_type,
+                                    count,
+                                    [&]()
+                                    {
+                                        float sum = 0.0f;
+                                        for (const float t : times) sum += SampleCurveValue(curve, t);
+                                        g_benchmark_sink = sum;
+                                        return samples;
+                                    }));
+
+    // forward playback over the whole curve in m_samples steps
+    const float step = static_cast<float>(std::max(count - 1, 1)) / static_cast<float>(samples);
+    results.push_back(TimeBenchmark(settings,
+                                    "SampleCurveValue/cursor",
+                                    handle_type,
+                                    count,
+                                    [&]()
+                                    {
+                                        float sum = 0.0f;
+                                        int cursor = 0;
+                                        for (int64_t s = 0; s < samples; ++s)
+                                        {
+                                            sum += SampleCurveValue(curve, static_cast<float>(s) * step, cursor);
+                                        }
+                                        g_benchmark_sink = sum;
+                                        return samples;
+                                    }));
+
+    results.push_back(TimeBenchmark(settings,
+                                    "FindSegmentIndex",
+                                    handle_type,
+                                    count,
+                                    [&]()
+                                    {
+                                        int sum = 0;
+                                        for (const float t : times) sum += FindSegmentIndex(curve.m_runtime, t);
+                                        g_benchmark_sink = static_cast<float>(sum);
+                                        return samples;
+                                    }));
+
+    if (count > 1)
+    {
+        // the segment and the time in it of every sample time
+        std::vector<std::pair<int, float>> targets{};
+        targets.reserve(times.size());
+        for (const float t : times) targets.emplace_back(FindSegmentIndex(curve.m_runtime, t), t);
+
+        const RuntimeCurve& runtime = curve.m_runtime;
+        results.push_back(TimeBenchmark(settings,
+                                        "FindTForX",
+                                        handle_type,
+                                        count,
+                                        [&]()
+                                        {
+                                            float sum = 0.0f;
+                                            for (const auto& [seg, t] : targets)
+                                            {
+                                                sum += FindTForX(runtime.m_segments[seg],
+                                                                 runtime.m_times[seg],
+                                                                 runtime.m_times[seg + 1],
+                                                                 t);
+                                            }
+                                            g_benchmark_sink = sum;
+                                            return samples;
+                                        }));
+    }
+
+    const Sequence seq = MakeBenchmarkQuatSequence(count, handle_type, rng);
+    results.push_back(TimeBenchmark(settings,
+                                    "SampleQuatForAnimation",
+                                    handle_type,
+                                    count,
+                                    [&]()
+                                    {
+                                        float sum = 0.0f;
+                                        for (const float t : times) sum += sequencer::SampleQuatForAnimation(seq, t).w;
+                                        g_benchmark_sink = sum;
+                                        return samples;
+                                    }));
+
+    results.push_back(TimeBenchmark(settings,
+                                    "ResolveCurveHandles",
+                                    handle_type,
+                                    count,
+                                    [&]()
+                                    {
+                                        ResolveCurveHandles(curve);
+                                        return int64_t{1};
+                                    }));
+
+    // the curve's own keyframe values, appended one at a time
+    results.push_back(TimeBenchmark(settings,
+                                    "AddKeyframe",
+                                    handle_type,
+                                    count,
+                                    [&]()
+                                    {
+                                        Curve built{};
+                                        SetCurveHandleType(built, handle_type);
+                                        LockCurveHandleType(built);
+                                        for (const Keyframe& keyframe : curve.m_keyframes)
+                                        {
+                                            AddKeyframe(built, keyframe.Time(), keyframe.Value());
+                                        }
+                                        g_benchmark_sink = built.m_runtime.m_values.back();
+                                        return static_cast<int64_t>(count);
+                                    }));
+}
+
+}  // namespace
+
+// === Running ===
+
+BenchmarkReport RunCurveBenchmarks(const BenchmarkSettings& settings)
+{
+    BenchmarkReport report{};
+    for (const int count : settings.m_keyframe_counts)
+    {
+        if (count < 2) continue;  // every curve has a first and a last keyframe
+
+        for (const CurveHandleType handle_type : settings.m_handle_types)
+        {
+            RunBenchmarksOf(settings, count, handle_type, report);
+        }
+    }
+    return report;
+}
+
+// === Output ===
+
+std::string BenchmarkReportToJson(const BenchmarkReport& report)
+{
+    nlohmann::json results = nlohmann::json::array();
+    for (const BenchmarkResult& result : report.m_results)
+    {
+        nlohmann::json result_js;
+        result_js["name"] = result.m_name;
+        result_js["handle_type"] = std::string(magic_enum::enum_name(result.m_handle_type));
+        result_js["keyframes"] = result.m_keyframe_count;
+        result_js["operations"] = result.m_operations;
+        result_js["ns_per_op"] = result.m_ns_per_op;
+        result_js["ns_per_op_best"] = result.m_ns_per_op_best;
+        results.push_back(result_js);
+    }
+
+    nlohmann::json json;
+    json["results"] = results;
+    return json.dump(2);
+}
+
+std::string BenchmarkReportToCsv(const BenchmarkReport& report)
+{
+    std::ostringstream csv;
+    csv << "name,handle_type,keyframes,operations,ns_per_op,ns_per_op_best\n";
+    for (const BenchmarkResult& result : report.m_results)
+    {
+        csv << result.m_name << ',' << magic_enum::enum_name(result.m_handle_type) << ',' << result.m_keyframe_count << ','
+            << result.m_operations << ',' << result.m_ns_per_op << ',' << result.m_ns_per_op_best << '\n';
+    }
+    return csv.str();
+}
+
+}  // namespace tanim
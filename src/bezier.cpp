@@ -2,9 +2,13 @@
 
 #include "tanim/include/curve_functions.hpp"
 #include "tanim/include/helpers.hpp"
+#include "tanim/include/profiler.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <limits>
+#include <optional>
 
 namespace tanim
 {
@@ -62,6 +66,33 @@ float CubicBezierDxDt(float p0x, float p1x, float p2x, float p3x, float t)
     return 3.0f * u2 * (p1x - p0x) + 6.0f * u * t * (p2x - p1x) + 3.0f * t2 * (p3x - p2x);
 }
 
+// === Power Basis Evaluation ===
+
+// f(t) = ((c[0] * t + c[1]) * t + c[2]) * t + c[3]
+static float EvaluatePowerBasis(const std::array<float, 4>& c, float t) { return ((c[0] * t + c[1]) * t + c[2]) * t + c[3]; }
+
+// f'(t) = (3 * c[0] * t + 2 * c[1]) * t + c[2]
+static float EvaluatePowerBasisDerivative(const std::array<float, 4>& c, float t)
+{
+    return (3.0f * c[0] * t + 2.0f * c[1]) * t + c[2];
+}
+
+// RuntimeCurve::m_revision: never 0, which marks data that was not compiled from a runtime curve yet
+static uint32_t NextRuntimeRevision()
+{
+    static std::atomic<uint32_t> revision{0};
+    uint32_t next = ++revision;
+    if (next == 0) next = ++revision;
+    return next;
+}
+
+// Bezier control points to power basis:
+// (-p0 + 3p1 - 3p2 + p3)t^3 + (3p0 - 6p1 + 3p2)t^2 + (-3p0 + 3p1)t + p0
+static std::array<float, 4> BezierToPowerBasis(float p0, float p1, float p2, float p3)
+{
+    return {-p0 + 3.0f * p1 - 3.0f * p2 + p3, 3.0f * p0 - 6.0f * p1 + 3.0f * p2, -3.0f * p0 + 3.0f * p1, p0};
+}
+
 // === Curve Sampling ===
 
 int FindSegmentIndex(const Curve& curve, float time)
@@ -73,15 +104,53 @@ int FindSegmentIndex(const Curve& curve, float time)
     if (time < keyframes.at(0).Time()) return -1;
     if (count == 1) return 0;
 
-    for (int i = 0; i < count - 1; i++)
+    // First keyframe at or after time. A time exactly on a keyframe belongs to the segment that ends there.
+    const auto it = std::lower_bound(keyframes.begin(),
+                                     keyframes.end(),
+                                     time,
+                                     [](const Keyframe& keyframe, float t) { return keyframe.Time() < t; });
+    const int idx = static_cast<int>(it - keyframes.begin());
+
+    return std::clamp(idx - 1, 0, count - 2);
+}
+
+int FindSegmentIndex(const RuntimeCurveView& runtime, float time)
+{
+    const auto& times = runtime.m_times;
+    const int count = static_cast<int>(times.size());
+
+    if (count == 0) return -1;
+    if (time < times[0]) return -1;
+    if (count == 1) return 0;
+
+    // First keyframe at or after time. A time exactly on a keyframe belongs to the segment that ends there.
+    const int idx = static_cast<int>(std::lower_bound(times.begin(), times.end(), time) - times.begin());
+
+    return std::clamp(idx - 1, 0, count - 2);
+}
+
+int FindSegmentIndex(const RuntimeCurveView& runtime, float time, int& cursor)
+{
+    const auto& times = runtime.m_times;
+    const int count = static_cast<int>(times.size());
+
+    auto contains = [&times](int seg, float t)
+    { return t <= times[seg + 1] && (t > times[seg] || (seg == 0 && t >= times[0])); };
+
+    if (count >= 2 && time >= times[0] && time <= times[count - 1])
     {
-        if (time >= keyframes.at(i).Time() && time <= keyframes.at(i + 1).Time())
+        // Forward playback stays in the current segment or steps into the next one
+        if (cursor >= 0 && cursor < count - 1)
         {
-            return i;
+            if (contains(cursor, time)) return cursor;
+            if (cursor + 1 < count - 1 && contains(cursor + 1, time)) return ++cursor;
         }
     }
 
-    return count - 2;  // Last segment
+    // Seeks and backward jumps
+    const int seg = FindSegmentIndex(runtime, time);
+    if (seg >= 0) cursor = seg;
+    return seg;
 }
 
 float FindTForX(float p0x, float p1x, float p2x, float p3x, float target_x)
@@ -93,6 +162,7 @@ float FindTForX(float p0x, float p1x, float p2x, float p3x, float target_x)
     // Newton-Raphson iterations
     for (int i = 0; i < 8; i++)
     {
+        TANIM_PROFILE_COUNT(ProfileCounter::NEWTON_ITERATIONS, 1);
         const float current_x = CubicBezierX(p0x, p1x, p2x, p3x, t);
         const float error = current_x - target_x;
         if (std::abs(error) < 1e-6f) break;
@@ -108,48 +178,274 @@ float FindTForX(float p0x, float p1x, float p2x, float p3x, float target_x)
     return t;
 }
 
-float SampleCurveValue(const Curve& curve, float time)
+float FindTForX(const CompiledSegment& segment, float start_x, float end_x, float target_x)
 {
-    const auto& keyframes = curve.m_keyframes;
-    const int count = static_cast<int>(keyframes.size());
+    const auto& c = segment.m_x;
 
-    if (count == 0) return 0.0f;
-    if (count == 1) return keyframes.at(0).Value();
+    // Initial guess using linear interpolation
+    float t = (target_x - start_x) / (end_x - start_x);
+    t = std::clamp(t, 0.0f, 1.0f);
 
-    // Before first keyframe
-    if (time <= keyframes.at(0).Time())
+    // Newton-Raphson iterations
+    for (int i = 0; i < 8; i++)
     {
-        return keyframes.at(0).Value();
+        TANIM_PROFILE_COUNT(ProfileCounter::NEWTON_ITERATIONS, 1);
+        const float current_x = EvaluatePowerBasis(c, t);
+        const float error = current_x - target_x;
+        if (std::abs(error) < 1e-6f) break;
+
+        const float dx_dt = EvaluatePowerBasisDerivative(c, t);
+        if (std::abs(dx_dt) < 1e-6f) break;  // x barely changes as t changes. means the curve is almost vertical in (t,x) space
+
+        t -= error / dx_dt;
+        t = std::clamp(t, 0.0f, 1.0f);
+    }
+
+    return t;
+}
+
+float SolveTForXAnalytic(const CompiledSegment& segment, float target_x)
+{
+    // c[0]t^3 + c[1]t^2 + c[2]t + (c[3] - x) = 0, in double so the closed forms keep float accuracy
+    const double a = segment.m_x[0];
+    const double b = segment.m_x[1];
+    const double c = segment.m_x[2];
+    const double d = static_cast<double>(segment.m_x[3]) - target_x;
+
+    // a root outside [0, 1] only comes from rounding (or a non-monotonic segment), the closest one is clamped into it
+    double best_t = 0.0;
+    double best_distance = std::numeric_limits<double>::infinity();
+    auto consider = [&best_t, &best_distance](double root)
+    {
+        const double distance = std::abs(root - std::clamp(root, 0.0, 1.0));
+        if (distance < best_distance)
+        {
+            best_t = root;
+            best_distance = distance;
+        }
+    };
+
+    // evenly spaced handles make x(t) linear, so a and b are often zero up to rounding
+    const double scale = std::abs(a) + std::abs(b) + std::abs(c);
+    if (std::abs(a) <= 1e-7 * scale)
+    {
+        if (std::abs(b) <= 1e-7 * scale)
+        {
+            consider(std::abs(c) > 0.0 ? -d / c : 0.0);
+        }
+        else
+        {
+            // quadratic, in the form that avoids cancellation
+            const double disc = std::max(c * c - 4.0 * b * d, 0.0);
+            const double q = -0.5 * (c + std::copysign(std::sqrt(disc), c));
+            consider(q / b);
+            if (q != 0.0) consider(d / q);
+        }
+    }
+    else
+    {
+        // depressed cubic s^3 + p*s + q = 0 with t = s - b / (3a)
+        const double bn = b / a;
+        const double cn = c / a;
+        const double dn = d / a;
+        const double shift = bn / 3.0;
+        const double p = cn - bn * bn / 3.0;
+        const double q = 2.0 * bn * bn * bn / 27.0 - bn * cn / 3.0 + dn;
+        const double disc = q * q / 4.0 + p * p * p / 27.0;
+
+        if (disc > 0.0)
+        {
+            // one real root (Cardano)
+            const double sqrt_disc = std::sqrt(disc);
+            consider(std::cbrt(-q / 2.0 + sqrt_disc) + std::cbrt(-q / 2.0 - sqrt_disc) - shift);
+        }
+        else
+        {
+            // three real roots (trigonometric form), p <= 0 here
+            const double r = std::sqrt(std::max(-p / 3.0, 0.0));
+            const double cos_arg = r > 0.0 ? std::clamp(-q / (2.0 * r * r * r), -1.0, 1.0) : 0.0;
+            const double phi = std::acos(cos_arg);
+            constexpr double two_pi_thirds = 2.0943951023931954923;
+            for (int k = 0; k < 3; k++)
+            {
+                consider(2.0 * r * std::cos(phi / 3.0 - two_pi_thirds * k) - shift);
+            }
+        }
+    }
+
+    return static_cast<float>(std::clamp(best_t, 0.0, 1.0));
+}
+
+TimeSolverAccuracy MeasureTimeSolverAccuracy(const RuntimeCurveView& runtime, int samples_per_segment)
+{
+    TimeSolverAccuracy accuracy{};
+    double value_difference_sum = 0.0;
+
+    for (int seg = 0; seg < static_cast<int>(runtime.m_segments.size()); seg++)
+    {
+        const CompiledSegment& segment = runtime.m_segments[seg];
+        if (segment.m_constant) continue;
+
+        const float start_x = runtime.m_times[seg];
+        const float end_x = runtime.m_times[seg + 1];
+        for (int sample = 0; sample < samples_per_segment; sample++)
+        {
+            const float target_x = start_x + (end_x - start_x) * (static_cast<float>(sample) + 0.5f) /
+                                                 static_cast<float>(samples_per_segment);
+
+            const float newton_t = FindTForX(segment, start_x, end_x, target_x);
+            const float analytic_t = SolveTForXAnalytic(segment, target_x);
+            const float value_difference =
+                std::abs(EvaluatePowerBasis(segment.m_y, newton_t) - EvaluatePowerBasis(segment.m_y, analytic_t));
+
+            accuracy.m_samples++;
+            accuracy.m_max_t_difference = std::max(accuracy.m_max_t_difference, std::abs(newton_t - analytic_t));
+            accuracy.m_max_value_difference = std::max(accuracy.m_max_value_difference, value_difference);
+            accuracy.m_max_newton_residual =
+                std::max(accuracy.m_max_newton_residual, std::abs(EvaluatePowerBasis(segment.m_x, newton_t) - target_x));
+            accuracy.m_max_analytic_residual =
+                std::max(accuracy.m_max_analytic_residual, std::abs(EvaluatePowerBasis(segment.m_x, analytic_t) - target_x));
+            value_difference_sum += value_difference;
+        }
+    }
+
+    if (accuracy.m_samples > 0)
+    {
+        accuracy.m_mean_value_difference = static_cast<float>(value_difference_sum / accuracy.m_samples);
+    }
+    return accuracy;
+}
+
+float SampleCurveValue(const Curve& curve, float time) { return SampleRuntimeCurve(curve.m_runtime, time); }
+
+float SampleCurveValue(const Curve& curve, float time, int& cursor) { return SampleRuntimeCurve(curve.m_runtime, time, cursor); }
+
+float SampleRuntimeCurve(const RuntimeCurveView& runtime, float time)
+{
+    TANIM_PROFILE_COUNT(ProfileCounter::CURVES_EVALUATED, 1);
+    const auto& times = runtime.m_times;
+
+    if (!runtime.m_lut_values.empty()) return SampleRuntimeLut(runtime, time);
+    if (times.empty()) return 0.0f;
+
+    // Before first keyframe (also covers a single keyframe)
+    if (time <= times.front())
+    {
+        return runtime.m_values.front();
     }
 
     // After last keyframe
-    if (time >= keyframes.at(count - 1).Time())
+    if (time >= times.back())
     {
-        return keyframes.at(count - 1).Value();
+        return runtime.m_values.back();
     }
 
     // Find segment
-    const int seg = FindSegmentIndex(curve, time);
-    if (seg < 0) return keyframes.at(0).Value();
+    const int seg = FindSegmentIndex(runtime, time);
+    if (seg < 0) return runtime.m_values.front();
 
-    const Keyframe& k0 = keyframes.at(seg);
-    const Keyframe& k1 = keyframes.at(seg + 1);
+    return SampleRuntimeSegment(runtime, seg, time);
+}
 
-    // Check for CONSTANT out-handle (step function)
-    if (k0.m_handle_type == HandleType::BROKEN && k0.m_out.m_broken_type == Handle::BrokenType::CONSTANT)
+float SampleRuntimeCurve(const RuntimeCurveView& runtime, float time, int& cursor)
+{
+    TANIM_PROFILE_COUNT(ProfileCounter::CURVES_EVALUATED, 1);
+    const auto& times = runtime.m_times;
+
+    if (!runtime.m_lut_values.empty()) return SampleRuntimeLut(runtime, time);
+    if (times.empty()) return 0.0f;
+    if (time <= times.front()) return runtime.m_values.front();
+    if (time >= times.back()) return runtime.m_values.back();
+
+    const int seg = FindSegmentIndex(runtime, time, cursor);
+    if (seg < 0) return runtime.m_values.front();
+
+    return SampleRuntimeSegment(runtime, seg, time);
+}
+
+float SampleRuntimeSegment(const RuntimeCurveView& runtime, int seg, float time)
+{
+    const auto& times = runtime.m_times;
+    const CompiledSegment& segment = runtime.m_segments[seg];
+
+    // CONSTANT out-handle (step function), or a level segment that never leaves its start value
+    if (segment.m_constant || segment.m_level)
     {
-        return k0.Value();
+        return segment.m_y.at(3);
     }
 
-    // Bezier control points
-    const ImVec2 p0 = k0.m_pos;
-    const ImVec2 p1 = k0.m_pos + k0.m_out.m_offset;
-    const ImVec2 p2 = k1.m_pos + k1.m_in.m_offset;
-    const ImVec2 p3 = k1.m_pos;
+    const float t = segment.m_analytic ? SolveTForXAnalytic(segment, time) : FindTForX(segment, times[seg], times[seg + 1], time);
 
-    const float t = FindTForX(p0.x, p1.x, p2.x, p3.x, time);
+    return EvaluatePowerBasis(segment.m_y, t);
+}
 
-    return CubicBezierY(p0.y, p1.y, p2.y, p3.y, t);
+float SampleRuntimeLut(const RuntimeCurveView& runtime, float time)
+{
+    const auto& values = runtime.m_lut_values;
+    const int last = static_cast<int>(values.size()) - 1;
+
+    const float pos = (time - runtime.m_lut_start) * runtime.m_lut_inv_step;
+    if (!(pos > 0.0f)) return values[0];
+    if (pos >= static_cast<float>(last)) return values[last];
+
+    const int idx = static_cast<int>(pos);
+    const float frac = pos - static_cast<float>(idx);
+    return values[idx] + (values[idx + 1] - values[idx]) * frac;
+}
+
+// === Hold Spans ===
+
+// hold outside the keyframes or the table, or nullopt if time is inside them
+static std::optional<HoldSpan> FindRuntimeHoldOutside(const RuntimeCurveView& runtime, float time)
+{
+    constexpr float kInf = std::numeric_limits<float>::infinity();
+    const auto& times = runtime.m_times;
+
+    if (!runtime.m_lut_values.empty())
+    {
+        // SampleRuntimeLut clamps to the first and last entries, the entries in between are lerped
+        const float pos = (time - runtime.m_lut_start) * runtime.m_lut_inv_step;
+        if (!(pos > 0.0f)) return HoldSpan{-kInf, runtime.m_lut_start};
+        if (pos >= static_cast<float>(runtime.m_lut_values.size() - 1)) return HoldSpan{std::nextafter(time, -kInf), kInf};
+        return HoldSpan{};
+    }
+
+    if (times.empty()) return HoldSpan{-kInf, kInf};
+    if (time <= times.front()) return HoldSpan{-kInf, times.front()};
+    if (time >= times.back()) return HoldSpan{std::nextafter(times.back(), -kInf), kInf};
+    return std::nullopt;
+}
+
+// the whole segment seg if its value never changes. it then equals the first keyframe for seg 0, and the last keyframe
+// for the last segment unless it is CONSTANT, so those holds run on before and after the keyframes.
+// a CONSTANT last segment stops just before the last keyframe, which SampleRuntimeCurve returns from its time on
+static HoldSpan FindSegmentHold(const RuntimeCurveView& runtime, int seg)
+{
+    constexpr float kInf = std::numeric_limits<float>::infinity();
+    const auto& times = runtime.m_times;
+    const CompiledSegment& segment = runtime.m_segments[seg];
+    const int last_seg = static_cast<int>(runtime.m_segments.size()) - 1;
+
+    if (!segment.m_constant && !segment.m_level) return {};
+
+    const float end = seg < last_seg ? times[seg + 1] : segment.m_constant ? std::nextafter(times[seg + 1], -kInf) : kInf;
+    return {seg == 0 ? -kInf : times[seg], end};
+}
+
+HoldSpan FindRuntimeHold(const RuntimeCurveView& runtime, float time)
+{
+    if (const auto outside = FindRuntimeHoldOutside(runtime, time)) return *outside;
+
+    const int seg = FindSegmentIndex(runtime, time);
+    return seg < 0 ? HoldSpan{} : FindSegmentHold(runtime, seg);
+}
+
+HoldSpan FindRuntimeHold(const RuntimeCurveView& runtime, float time, int& cursor)
+{
+    if (const auto outside = FindRuntimeHoldOutside(runtime, time)) return *outside;
+
+    const int seg = FindSegmentIndex(runtime, time, cursor);
+    return seg < 0 ? HoldSpan{} : FindSegmentHold(runtime, seg);
 }
 
 ImVec2 SampleCurveForDrawing(const Curve& curve, float t_param, const ImVec2& min, const ImVec2& max)
@@ -447,6 +743,157 @@ void ResolveCurveHandles(Curve& curve)
 
         ResolveKeyframeHandles(curve.m_keyframes.at(i), prev, next);
     }
+
+    CompileCurve(curve);
+}
+
+// Segment seg of curve in runtime form
+static CompiledSegment CompileCurveSegment(const Curve& curve, int seg)
+{
+    CompiledSegment segment = CompileSegment(curve.m_keyframes.at(seg), curve.m_keyframes.at(seg + 1));
+    segment.m_analytic = curve.m_time_solver == TimeSolver::ANALYTIC;
+    return segment;
+}
+
+void ResolveKeyframeRange(Curve& curve, int first, int last)
+{
+    const int count = GetKeyframeCount(curve);
+    RuntimeCurve& runtime = curve.m_runtime;
+
+    if (static_cast<int>(runtime.m_times.size()) != count || static_cast<int>(runtime.m_segments.size()) != std::max(count - 1, 0))
+    {
+        ResolveCurveHandles(curve);
+        return;
+    }
+    if (count == 0) return;
+
+    first = std::clamp(first, 0, count - 1);
+    last = std::clamp(last, first, count - 1);
+
+    // Handles read the positions of their neighbours
+    const int resolve_first = std::max(first - 1, 0);
+    const int resolve_last = std::min(last + 1, count - 1);
+    for (int i = resolve_first; i <= resolve_last; i++)
+    {
+        const Keyframe* prev = (i > 0) ? &curve.m_keyframes.at(i - 1) : nullptr;
+        const Keyframe* next = (i < count - 1) ? &curve.m_keyframes.at(i + 1) : nullptr;
+
+        Keyframe& keyframe = curve.m_keyframes.at(i);
+        ResolveKeyframeHandles(keyframe, prev, next);
+
+        runtime.m_times.at(i) = keyframe.Time();
+        runtime.m_values.at(i) = keyframe.Value();
+        runtime.m_in_tangents.at(i) = keyframe.m_in.m_offset;
+        runtime.m_out_tangents.at(i) = keyframe.m_out.m_offset;
+    }
+
+    // A segment reads the keyframes at both of its ends
+    for (int seg = std::max(resolve_first - 1, 0); seg <= std::min(resolve_last, count - 2); seg++)
+    {
+        runtime.m_segments.at(seg) = CompileCurveSegment(curve, seg);
+    }
+
+    runtime.m_lut_values.clear();  // see BakeCurveLut
+    runtime.m_revision = NextRuntimeRevision();
+}
+
+// === Runtime Curve Baking ===
+
+CompiledSegment CompileSegment(const Keyframe& k0, const Keyframe& k1)
+{
+    CompiledSegment segment;
+
+    // Check for CONSTANT out-handle (step function)
+    segment.m_constant = k0.m_handle_type == HandleType::BROKEN && k0.m_out.m_broken_type == Handle::BrokenType::CONSTANT;
+    segment.m_flat = k0.m_handle_type == HandleType::SMOOTH && k0.m_out.m_smooth_type == Handle::SmoothType::FLAT;
+    segment.m_level = k0.Value() == k1.Value() && k0.m_out.m_offset.y == 0.0f && k1.m_in.m_offset.y == 0.0f;
+
+    // Bezier control points
+    const ImVec2 p0 = k0.m_pos;
+    const ImVec2 p1 = k0.m_pos + k0.m_out.m_offset;
+    const ImVec2 p2 = k1.m_pos + k1.m_in.m_offset;
+    const ImVec2 p3 = k1.m_pos;
+
+    segment.m_x = BezierToPowerBasis(p0.x, p1.x, p2.x, p3.x);
+    segment.m_y = BezierToPowerBasis(p0.y, p1.y, p2.y, p3.y);
+
+    return segment;
+}
+
+RuntimeCurve BakeRuntimeCurve(const Curve& curve)
+{
+    RuntimeCurve runtime;
+    BakeRuntimeCurve(curve, runtime);
+    return runtime;
+}
+
+void BakeRuntimeCurve(const Curve& curve, RuntimeCurve& runtime)
+{
+    const auto& keyframes = curve.m_keyframes;
+    const int count = GetKeyframeCount(curve);
+
+    runtime.m_times.clear();
+    runtime.m_values.clear();
+    runtime.m_in_tangents.clear();
+    runtime.m_out_tangents.clear();
+    runtime.m_segments.clear();
+    runtime.m_lut_values.clear();  // any table is stale now, see BakeCurveLut
+    runtime.m_revision = NextRuntimeRevision();
+
+    if (count == 0) return;
+
+    runtime.m_times.reserve(count);
+    runtime.m_values.reserve(count);
+    runtime.m_in_tangents.reserve(count);
+    runtime.m_out_tangents.reserve(count);
+    runtime.m_segments.reserve(count - 1);
+
+    for (int i = 0; i < count; i++)
+    {
+        const Keyframe& keyframe = keyframes.at(i);
+        runtime.m_times.push_back(keyframe.Time());
+        runtime.m_values.push_back(keyframe.Value());
+        runtime.m_in_tangents.push_back(keyframe.m_in.m_offset);
+        runtime.m_out_tangents.push_back(keyframe.m_out.m_offset);
+        if (i < count - 1)
+        {
+            runtime.m_segments.push_back(CompileCurveSegment(curve, i));
+        }
+    }
+}
+
+void CompileCurve(Curve& curve) { BakeRuntimeCurve(curve, curve.m_runtime); }
+
+void InsertRuntimeKeyframe(RuntimeCurve& runtime, int keyframe_index)
+{
+    runtime.m_times.insert(runtime.m_times.begin() + keyframe_index, 0.0f);
+    runtime.m_values.insert(runtime.m_values.begin() + keyframe_index, 0.0f);
+    runtime.m_in_tangents.insert(runtime.m_in_tangents.begin() + keyframe_index, ImVec2{});
+    runtime.m_out_tangents.insert(runtime.m_out_tangents.begin() + keyframe_index, ImVec2{});
+
+    // The segment that contained the new keyframe is split in two
+    if (runtime.m_times.size() >= 2)
+    {
+        const int seg = std::min(keyframe_index, static_cast<int>(runtime.m_segments.size()));
+        runtime.m_segments.insert(runtime.m_segments.begin() + seg, CompiledSegment{});
+    }
+    runtime.m_revision = NextRuntimeRevision();
+}
+
+void EraseRuntimeKeyframe(RuntimeCurve& runtime, int keyframe_index)
+{
+    runtime.m_times.erase(runtime.m_times.begin() + keyframe_index);
+    runtime.m_values.erase(runtime.m_values.begin() + keyframe_index);
+    runtime.m_in_tangents.erase(runtime.m_in_tangents.begin() + keyframe_index);
+    runtime.m_out_tangents.erase(runtime.m_out_tangents.begin() + keyframe_index);
+
+    // The two segments around the erased keyframe merge into one
+    if (!runtime.m_segments.empty())
+    {
+        const int seg = std::min(keyframe_index, static_cast<int>(runtime.m_segments.size()) - 1);
+        runtime.m_segments.erase(runtime.m_segments.begin() + seg);
+    }
+    runtime.m_revision = NextRuntimeRevision();
 }
 
 // === Handle Constraint Helpers ===
@@ -0,0 +1,466 @@
+#include "tanim/include/bezier_batch.hpp"
+
+#include "tanim/include/bezier.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#if !defined(TANIM_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define TANIM_BEZIER_LANES_AVX2
+#elif !defined(TANIM_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define TANIM_BEZIER_LANES_SSE2
+#endif
+
+namespace tanim
+{
+
+namespace
+{
+
+// === Lanes ===
+// the few vector operations the kernels need. masks are all-ones/all-zeros lanes, as the compare instructions produce
+
+#if defined(TANIM_BEZIER_LANES_AVX2)
+
+struct Lanes
+{
+    using V = __m256;
+    static constexpr int kWidth = 8;
+
+    static V Load(const float* src) { return _mm256_loadu_ps(src); }
+    static void Store(float* dst, V a) { _mm256_storeu_ps(dst, a); }
+    static V Set(float value) { return _mm256_set1_ps(value); }
+    static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V Abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static V Less(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static V Select(V mask, V a, V b) { return _mm256_blendv_ps(b, a, mask); }
+    static V Clear(V mask, V a) { return _mm256_andnot_ps(mask, a); }  // a & ~mask
+    static V AllSet() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+    static bool Any(V mask) { return _mm256_movemask_ps(mask) != 0; }
+};
+
+#elif defined(TANIM_BEZIER_LANES_SSE2)
+
+struct Lanes
+{
+    using V = __m128;
+    static constexpr int kWidth = 4;
+
+    static V Load(const float* src) { return _mm_loadu_ps(src); }
+    static void Store(float* dst, V a) { _mm_storeu_ps(dst, a); }
+    static V Set(float value) { return _mm_set1_ps(value); }
+    static V Add(V a, V b) { return _mm_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm_div_ps(a, b); }
+    static V Abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static V Less(V a, V b) { return _mm_cmplt_ps(a, b); }
+    static V Select(V mask, V a, V b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    static V Clear(V mask, V a) { return _mm_andnot_ps(mask, a); }  // a & ~mask
+    static V AllSet() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+    static bool Any(V mask) { return _mm_movemask_ps(mask) != 0; }
+};
+
+#endif
+
+#if defined(TANIM_BEZIER_LANES_AVX2) || defined(TANIM_BEZIER_LANES_SSE2)
+#define TANIM_BEZIER_LANES
+
+using V = Lanes::V;
+
+// === Lane Kernels ===
+// each one repeats the operations of its scalar counterpart in bezier.cpp in the same order, see bezier_batch.hpp
+
+// std::clamp(t, 0, 1), including passing NaN through
+V Clamp01(V t)
+{
+    const V zero = Lanes::Set(0.0f);
+    const V one = Lanes::Set(1.0f);
+    return Lanes::Select(Lanes::Less(t, zero), zero, Lanes::Select(Lanes::Less(one, t), one, t));
+}
+
+// CubicBezierX / CubicBezierY
+V CubicBezierLanes(V p0, V p1, V p2, V p3, V t)
+{
+    const V three = Lanes::Set(3.0f);
+    const V u = Lanes::Sub(Lanes::Set(1.0f), t);
+    const V u2 = Lanes::Mul(u, u);
+    const V u3 = Lanes::Mul(u2, u);
+    const V t2 = Lanes::Mul(t, t);
+    const V t3 = Lanes::Mul(t2, t);
+
+    V result = Lanes::Mul(u3, p0);
+    result = Lanes::Add(result, Lanes::Mul(Lanes::Mul(Lanes::Mul(three, u2), t), p1));
+    result = Lanes::Add(result, Lanes::Mul(Lanes::Mul(Lanes::Mul(three, u), t2), p2));
+    return Lanes::Add(result, Lanes::Mul(t3, p3));
+}
+
+// CubicBezierDxDt
+V CubicBezierDxDtLanes(V p0, V p1, V p2, V p3, V t)
+{
+    const V u = Lanes::Sub(Lanes::Set(1.0f), t);
+    const V u2 = Lanes::Mul(u, u);
+    const V t2 = Lanes::Mul(t, t);
+
+    V result = Lanes::Mul(Lanes::Mul(Lanes::Set(3.0f), u2), Lanes::Sub(p1, p0));
+    result = Lanes::Add(result, Lanes::Mul(Lanes::Mul(Lanes::Mul(Lanes::Set(6.0f), u), t), Lanes::Sub(p2, p1)));
+    return Lanes::Add(result, Lanes::Mul(Lanes::Mul(Lanes::Set(3.0f), t2), Lanes::Sub(p3, p2)));
+}
+
+// Newton-Raphson shared by both FindTForX versions. x(t) and dx_dt(t) evaluate the curve on all lanes.
+// a lane stops at the first iteration the scalar loop would break on, the others keep going
+template <typename XFn, typename DxDtFn>
+V SolveTForXLanes(V t, V target_x, const XFn& x, const DxDtFn& dx_dt)
+{
+    const V epsilon = Lanes::Set(1e-6f);
+    V active = Lanes::AllSet();
+
+    for (int i = 0; i < 8; i++)
+    {
+        const V error = Lanes::Sub(x(t), target_x);
+        active = Lanes::Clear(Lanes::Less(Lanes::Abs(error), epsilon), active);
+        if (!Lanes::Any(active)) break;
+
+        const V slope = dx_dt(t);
+        active = Lanes::Clear(Lanes::Less(Lanes::Abs(slope), epsilon), active);
+        if (!Lanes::Any(active)) break;
+
+        t = Lanes::Select(active, Clamp01(Lanes::Sub(t, Lanes::Div(error, slope))), t);
+    }
+
+    return t;
+}
+
+// FindTForX on Bezier control points
+V FindTForXLanes(V p0, V p1, V p2, V p3, V target_x)
+{
+    // Initial guess using linear interpolation
+    const V t = Clamp01(Lanes::Div(Lanes::Sub(target_x, p0), Lanes::Sub(p3, p0)));
+
+    return SolveTForXLanes(t,
+                           target_x,
+                           [&](V t_lanes) { return CubicBezierLanes(p0, p1, p2, p3, t_lanes); },
+                           [&](V t_lanes) { return CubicBezierDxDtLanes(p0, p1, p2, p3, t_lanes); });
+}
+
+// f(t) = ((c[0] * t + c[1]) * t + c[2]) * t + c[3]
+V EvaluatePowerBasisLanes(const V* c, V t)
+{
+    return Lanes::Add(Lanes::Mul(Lanes::Add(Lanes::Mul(Lanes::Add(Lanes::Mul(c[0], t), c[1]), t), c[2]), t), c[3]);
+}
+
+// f'(t) = (3 * c[0] * t + 2 * c[1]) * t + c[2]
+V EvaluatePowerBasisDerivativeLanes(const V* c, V t)
+{
+    const V lead = Lanes::Mul(Lanes::Mul(Lanes::Set(3.0f), c[0]), t);
+    return Lanes::Add(Lanes::Mul(Lanes::Add(lead, Lanes::Mul(Lanes::Set(2.0f), c[1])), t), c[2]);
+}
+
+#endif
+
+// === Batch Driver ===
+
+// one input of a batch: a span read per lane, or a single value broadcast to every lane
+struct BatchInput
+{
+    const float* m_data;
+    size_t m_stride;  // 1 for spans, 0 for broadcast values
+
+    BatchInput(std::span<const float> values, size_t count) : m_data(values.data()), m_stride(1)
+    {
+        assert(values.size() >= count);
+        (void)count;
+    }
+
+    BatchInput(const float& value) : m_data(&value), m_stride(0) {}
+
+    float At(size_t idx) const { return m_data[idx * m_stride]; }
+
+#ifdef TANIM_BEZIER_LANES
+    V LoadLanes(size_t idx) const { return m_stride != 0 ? Lanes::Load(m_data + idx) : Lanes::Set(*m_data); }
+#endif
+};
+
+// out[i] = fn(in[i]...) in steps of Lanes::kWidth, the remainder through the scalar function
+template <typename LaneFn, typename ScalarFn>
+void RunBatch(const LaneFn& lane_fn,
+              const ScalarFn& scalar_fn,
+              const BatchInput& p0,
+              const BatchInput& p1,
+              const BatchInput& p2,
+              const BatchInput& p3,
+              const BatchInput& t,
+              std::span<float> out)
+{
+    const size_t count = out.size();
+    size_t idx = 0;
+
+#ifdef TANIM_BEZIER_LANES
+    for (; idx + Lanes::kWidth <= count; idx += Lanes::kWidth)
+    {
+        const V result = lane_fn(p0.LoadLanes(idx), p1.LoadLanes(idx), p2.LoadLanes(idx), p3.LoadLanes(idx), t.LoadLanes(idx));
+        Lanes::Store(out.data() + idx, result);
+    }
+#else
+    (void)lane_fn;
+#endif
+
+    for (; idx < count; ++idx)
+    {
+        out[idx] = scalar_fn(p0.At(idx), p1.At(idx), p2.At(idx), p3.At(idx), t.At(idx));
+    }
+}
+
+#ifdef TANIM_BEZIER_LANES
+constexpr auto kCubicBezierLanes = &CubicBezierLanes;
+constexpr auto kCubicBezierDxDtLanes = &CubicBezierDxDtLanes;
+constexpr auto kFindTForXLanes = &FindTForXLanes;
+#else
+constexpr int kCubicBezierLanes = 0;
+constexpr int kCubicBezierDxDtLanes = 0;
+constexpr int kFindTForXLanes = 0;
+#endif
+
+float FindTForXScalar(float p0x, float p1x, float p2x, float p3x, float target_x)
+{
+    return FindTForX(p0x, p1x, p2x, p3x, target_x);
+}
+
+}  // namespace
+
+int GetBezierBatchWidth()
+{
+#ifdef TANIM_BEZIER_LANES
+    return Lanes::kWidth;
+#else
+    return 1;
+#endif
+}
+
+// === CubicBezierBatch ===
+
+void CubicBezierBatch(std::span<const float> p0,
+                      std::span<const float> p1,
+                      std::span<const float> p2,
+                      std::span<const float> p3,
+                      std::span<const float> t,
+                      std::span<float> out)
+{
+    const size_t count = out.size();
+    RunBatch(kCubicBezierLanes, CubicBezierX, {p0, count}, {p1, count}, {p2, count}, {p3, count}, {t, count}, out);
+}
+
+void CubicBezierBatch(std::span<const float> p0,
+                      std::span<const float> p1,
+                      std::span<const float> p2,
+                      std::span<const float> p3,
+                      float t,
+                      std::span<float> out)
+{
+    const size_t count = out.size();
+    RunBatch(kCubicBezierLanes, CubicBezierX, {p0, count}, {p1, count}, {p2, count}, {p3, count}, t, out);
+}
+
+void CubicBezierBatch(float p0, float p1, float p2, float p3, std::span<const float> t, std::span<float> out)
+{
+    RunBatch(kCubicBezierLanes, CubicBezierX, p0, p1, p2, p3, {t, out.size()}, out);
+}
+
+// === CubicBezierDxDtBatch ===
+
+void CubicBezierDxDtBatch(std::span<const float> p0,
+                          std::span<const float> p1,
+                          std::span<const float> p2,
+                          std::span<const float> p3,
+                          std::span<const float> t,
+                          std::span<float> out)
+{
+    const size_t count = out.size();
+    RunBatch(kCubicBezierDxDtLanes, CubicBezierDxDt, {p0, count}, {p1, count}, {p2, count}, {p3, count}, {t, count}, out);
+}
+
+void CubicBezierDxDtBatch(std::span<const float> p0,
+                          std::span<const float> p1,
+                          std::span<const float> p2,
+                          std::span<const float> p3,
+                          float t,
+                          std::span<float> out)
+{
+    const size_t count = out.size();
+    RunBatch(kCubicBezierDxDtLanes, CubicBezierDxDt, {p0, count}, {p1, count}, {p2, count}, {p3, count}, t, out);
+}
+
+void CubicBezierDxDtBatch(float p0, float p1, float p2, float p3, std::span<const float> t, std::span<float> out)
+{
+    RunBatch(kCubicBezierDxDtLanes, CubicBezierDxDt, p0, p1, p2, p3, {t, out.size()}, out);
+}
+
+// === FindTForXBatch ===
+
+void FindTForXBatch(std::span<const float> p0x,
+                    std::span<const float> p1x,
+                    std::span<const float> p2x,
+                    std::span<const float> p3x,
+                    std::span<const float> target_x,
+                    std::span<float> out_t)
+{
+    const size_t count = out_t.size();
+    RunBatch(kFindTForXLanes,
+             FindTForXScalar,
+             {p0x, count},
+             {p1x, count},
+             {p2x, count},
+             {p3x, count},
+             {target_x, count},
+             out_t);
+}
+
+void FindTForXBatch(std::span<const float> p0x,
+                    std::span<const float> p1x,
+                    std::span<const float> p2x,
+                    std::span<const float> p3x,
+                    float target_x,
+                    std::span<float> out_t)
+{
+    const size_t count = out_t.size();
+    RunBatch(kFindTForXLanes, FindTForXScalar, {p0x, count}, {p1x, count}, {p2x, count}, {p3x, count}, target_x, out_t);
+}
+
+void FindTForXBatch(float p0x, float p1x, float p2x, float p3x, std::span<const float> target_x, std::span<float> out_t)
+{
+    RunBatch(kFindTForXLanes, FindTForXScalar, p0x, p1x, p2x, p3x, {target_x, out_t.size()}, out_t);
+}
+
+// === SampleRuntimeCurveBatch ===
+
+void SampleRuntimeCurveBatch(const RuntimeCurveView& runtime, std::span<const float> times, std::span<float> out)
+{
+    assert(times.size() >= out.size());
+
+    if (!runtime.m_lut_values.empty())
+    {
+        for (size_t idx = 0; idx < out.size(); ++idx) out[idx] = SampleRuntimeLut(runtime, times[idx]);
+        return;
+    }
+
+#ifdef TANIM_BEZIER_LANES
+    const auto& keyframe_times = runtime.m_times;
+    if (keyframe_times.empty())
+    {
+        std::fill(out.begin(), out.end(), 0.0f);
+        return;
+    }
+
+    // times that land inside a Bezier segment are gathered into lane arrays (SoA), solved together, then scattered back.
+    // all other cases are resolved right away, exactly like SampleRuntimeCurve
+    constexpr int kChunk = 64;
+    alignas(32) float coefficients_x[4][kChunk];
+    alignas(32) float coefficients_y[4][kChunk];
+    alignas(32) float start_x[kChunk];
+    alignas(32) float end_x[kChunk];
+    alignas(32) float target_x[kChunk];
+    int out_indices[kChunk];
+
+    int cursor = 0;
+    size_t idx = 0;
+    while (idx < out.size())
+    {
+        int gathered = 0;
+        for (; idx < out.size() && gathered < kChunk; ++idx)
+        {
+            const float time = times[idx];
+            if (time <= keyframe_times.front())
+            {
+                out[idx] = runtime.m_values.front();
+                continue;
+            }
+            if (time >= keyframe_times.back())
+            {
+                out[idx] = runtime.m_values.back();
+                continue;
+            }
+
+            const int seg = FindSegmentIndex(runtime, time, cursor);
+            if (seg < 0)
+            {
+                out[idx] = runtime.m_values.front();
+                continue;
+            }
+
+            const CompiledSegment& segment = runtime.m_segments[seg];
+            if (segment.m_constant || segment.m_level || segment.m_analytic)
+            {
+                out[idx] = SampleRuntimeSegment(runtime, seg, time);
+                continue;
+            }
+
+            for (int c = 0; c < 4; ++c)
+            {
+                coefficients_x[c][gathered] = segment.m_x[c];
+                coefficients_y[c][gathered] = segment.m_y[c];
+            }
+            start_x[gathered] = keyframe_times[seg];
+            end_x[gathered] = keyframe_times[seg + 1];
+            target_x[gathered] = time;
+            out_indices[gathered] = static_cast<int>(idx);
+            gathered++;
+        }
+
+        // pad the last step with copies of a solved lane instead of a scalar tail, its results are not scattered
+        const int padded = (gathered + Lanes::kWidth - 1) / Lanes::kWidth * Lanes::kWidth;
+        for (int lane = gathered; lane < padded; ++lane)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                coefficients_x[c][lane] = coefficients_x[c][0];
+                coefficients_y[c][lane] = coefficients_y[c][0];
+            }
+            start_x[lane] = start_x[0];
+            end_x[lane] = end_x[0];
+            target_x[lane] = target_x[0];
+        }
+
+        alignas(32) float values[kChunk];
+        for (int lane = 0; lane < padded; lane += Lanes::kWidth)
+        {
+            V cx[4];
+            V cy[4];
+            for (int c = 0; c < 4; ++c)
+            {
+                cx[c] = Lanes::Load(coefficients_x[c] + lane);
+                cy[c] = Lanes::Load(coefficients_y[c] + lane);
+            }
+            const V target = Lanes::Load(target_x + lane);
+            const V start = Lanes::Load(start_x + lane);
+            const V end = Lanes::Load(end_x + lane);
+
+            // Initial guess using linear interpolation, then the same solve as FindTForX(const CompiledSegment&, ...)
+            const V guess = Clamp01(Lanes::Div(Lanes::Sub(target, start), Lanes::Sub(end, start)));
+            const V t = SolveTForXLanes(guess,
+                                        target,
+                                        [&cx](V t_lanes) { return EvaluatePowerBasisLanes(cx, t_lanes); },
+                                        [&cx](V t_lanes) { return EvaluatePowerBasisDerivativeLanes(cx, t_lanes); });
+
+            Lanes::Store(values + lane, EvaluatePowerBasisLanes(cy, t));
+        }
+
+        for (int lane = 0; lane < gathered; ++lane)
+        {
+            out[out_indices[lane]] = values[lane];
+        }
+    }
+#else
+    int cursor = 0;
+    for (size_t idx = 0; idx < out.size(); ++idx)
+    {
+        out[idx] = SampleRuntimeCurve(runtime, times[idx], cursor);
+    }
+#endif
+}
+
+}  // namespace tanim
@@ -0,0 +1,296 @@
+#include "tanim/include/tanim.hpp"
+
+#include "tanim/include/binary_io.hpp"
+#include "tanim/include/curve_functions.hpp"
+#include "tanim/include/bezier.hpp"
+#include "tanim/include/user_override.hpp"
+
+namespace tanim
+{
+
+/*
+ * Tanim binary timeline, all values little-endian. holds exactly what the version 2 JSON holds.
+ *
+ * header:
+ *     u8[4] magic "TANB"
+ *     u32   binary format version
+ *     u32   JSON schema version it mirrors (2)
+ *     u32   string count, sequence count, curve count, keyframe count (totals, for reserving)
+ * string table:
+ *     per string: u32 length, bytes
+ * timeline:
+ *     u32 name, i32 first frame, last frame, min frame, max frame, u8 play immediately, i32 player samples, u8 playback type
+ * per sequence:
+ *     u32 uid, display, struct name, field name (string table indices)
+ *     u8 type meta, u8 representation meta, i32 last frame, i32 first frame, u32 curve count
+ *     per curve:
+ *         u32 name, u8 handle type locked, u8 curve handle type, u32 keyframe count
+ *         packed keyframes: f32 pos x, f32 pos y, u8 handle type, in handle, out handle
+ *         handle: f32 offset x, f32 offset y, u8 weighted, u8 smooth type, u8 broken type
+ *
+ * version history:
+ * 1:
+ *     initial version, mirrors JSON version 2
+ */
+
+namespace
+{
+
+constexpr std::string_view kBinaryMagic{"TANB"};
+constexpr uint32_t kBinaryVersion = 1;
+constexpr uint32_t kJsonSchemaVersion = 2;
+
+// serialized size of each record, without the records it contains (see the layout above). the counts of a file are
+// checked against them before anything is allocated, so a corrupt count can't ask for more than the file could hold
+constexpr size_t kStringBytes = 4;                     // length, without the characters
+constexpr size_t kSequenceBytes = 4 * 4 + 1 + 1 + 4 + 4 + 4;
+constexpr size_t kCurveBytes = 4 + 1 + 1 + 4;
+constexpr size_t kHandleBytes = 4 + 4 + 1 + 1 + 1;
+constexpr size_t kKeyframeBytes = 4 + 4 + 1 + 2 * kHandleBytes;
+
+void WriteHandle(BinaryWriter& writer, const Handle& handle)
+{
+    writer.WriteF32(handle.m_offset.x);
+    writer.WriteF32(handle.m_offset.y);
+    writer.WriteBool(handle.m_weighted);
+    writer.WriteEnum(handle.m_smooth_type);
+    writer.WriteEnum(handle.m_broken_type);
+}
+
+template <typename EnumType>
+EnumType ReadEnum(BinaryReader& reader, EnumType fallback)
+{
+    return magic_enum::enum_cast<EnumType>(static_cast<std::underlying_type_t<EnumType>>(reader.ReadU8())).value_or(fallback);
+}
+
+void ReadHandle(BinaryReader& reader, Handle& handle)
+{
+    handle.m_offset.x = reader.ReadF32();
+    handle.m_offset.y = reader.ReadF32();
+    handle.m_weighted = reader.ReadBool();
+    handle.m_smooth_type = ReadEnum(reader, Handle::SmoothType::AUTO);
+    handle.m_broken_type = ReadEnum(reader, Handle::BrokenType::UNUSED);
+}
+
+}  // namespace
+
+std::vector<uint8_t> Tanim::SerializeBinary(const TimelineData& tdata)
+{
+    StringTable strings{};
+    uint32_t curve_total = 0;
+    uint32_t keyframe_total = 0;
+
+    // strings are interned in a first pass, so the table can precede the data that refers to it
+    const uint32_t name_idx = strings.Intern(tdata.m_name);
+    for (const auto& seq : tdata.m_sequences)
+    {
+        strings.Intern(seq.m_seq_id.GetEntityData().m_uid);
+        strings.Intern(seq.m_seq_id.GetEntityData().m_display);
+        strings.Intern(seq.m_seq_id.StructName());
+        strings.Intern(seq.m_seq_id.FieldName());
+        for (const auto& curve : seq.m_curves)
+        {
+            strings.Intern(curve.m_name);
+            curve_total++;
+            keyframe_total += static_cast<uint32_t>(curve.m_keyframes.size());
+        }
+    }
+
+    BinaryWriter writer{};
+
+    // === Header ===
+    writer.WriteBytes(kBinaryMagic);
+    writer.WriteU32(kBinaryVersion);
+    writer.WriteU32(kJsonSchemaVersion);
+    writer.WriteU32(static_cast<uint32_t>(strings.GetStrings().size()));
+    writer.WriteU32(static_cast<uint32_t>(tdata.m_sequences.size()));
+    writer.WriteU32(curve_total);
+    writer.WriteU32(keyframe_total);
+
+    // === String Table ===
+    for (const auto& str : strings.GetStrings())
+    {
+        writer.WriteU32(static_cast<uint32_t>(str.size()));
+        writer.WriteBytes(str);
+    }
+
+    // === Timeline ===
+    writer.WriteU32(name_idx);
+    writer.WriteI32(tdata.m_first_frame);
+    writer.WriteI32(tdata.m_last_frame);
+    writer.WriteI32(tdata.m_min_frame);
+    writer.WriteI32(tdata.m_max_frame);
+    writer.WriteBool(tdata.m_play_immediately);
+    writer.WriteI32(tdata.m_player_samples);
+    writer.WriteEnum(tdata.m_playback_type);
+
+    // === Sequences ===
+    for (const auto& seq : tdata.m_sequences)
+    {
+        writer.WriteU32(strings.Intern(seq.m_seq_id.GetEntityData().m_uid));
+        writer.WriteU32(strings.Intern(seq.m_seq_id.GetEntityData().m_display));
+        writer.WriteU32(strings.Intern(seq.m_seq_id.StructName()));
+        writer.WriteU32(strings.Intern(seq.m_seq_id.FieldName()));
+        writer.WriteEnum(seq.m_type_meta);
+        writer.WriteEnum(seq.m_representation_meta);
+        writer.WriteI32(seq.m_last_frame);
+        writer.WriteI32(seq.m_first_frame);
+        writer.WriteU32(static_cast<uint32_t>(seq.m_curves.size()));
+
+        for (const auto& curve : seq.m_curves)
+        {
+            writer.WriteU32(strings.Intern(curve.m_name));
+            writer.WriteBool(curve.m_handle_type_locked);
+            writer.WriteEnum(curve.m_curve_handle_type);
+            writer.WriteU32(static_cast<uint32_t>(curve.m_keyframes.size()));
+
+            for (const auto& keyframe : curve.m_keyframes)
+            {
+                writer.WriteF32(keyframe.m_pos.x);
+                writer.WriteF32(keyframe.m_pos.y);
+                writer.WriteEnum(keyframe.m_handle_type);
+                WriteHandle(writer, keyframe.m_in);
+                WriteHandle(writer, keyframe.m_out);
+            }
+        }
+    }
+
+    return std::move(writer.GetBytes());
+}
+
+bool Tanim::DeserializeBinary(TimelineData& data, std::span<const uint8_t> bytes)
+{
+    TANIM_PROFILE_SCOPE(ProfileScope::DESERIALIZE);
+
+    BinaryReader reader(bytes);
+
+    // === Header ===
+    if (reader.ReadBytes(kBinaryMagic.size()) != kBinaryMagic)
+    {
+        LogError("Not a Tanim binary timeline. Can not deserialize.");
+        return false;
+    }
+
+    const uint32_t binary_version = reader.ReadU32();
+    const uint32_t schema_version = reader.ReadU32();
+    if (binary_version != kBinaryVersion || schema_version != kJsonSchemaVersion)
+    {
+        LogError("Unsupported Tanim binary version " + std::to_string(binary_version) + " (schema " +
+                 std::to_string(schema_version) + "). Can not deserialize.");
+        return false;
+    }
+
+    const uint32_t string_count = reader.ReadU32();
+    const uint32_t sequence_count = reader.ReadU32();
+    const uint32_t curve_total = reader.ReadU32();
+    const uint32_t keyframe_total = reader.ReadU32();
+
+    // larger counts than the rest of the file can hold can only come from a corrupt file
+    const uint64_t remaining = reader.GetRemaining();
+    const uint64_t min_bytes = uint64_t{string_count} * kStringBytes + uint64_t{sequence_count} * kSequenceBytes +
+                               uint64_t{curve_total} * kCurveBytes + uint64_t{keyframe_total} * kKeyframeBytes;
+    if (min_bytes > remaining)
+    {
+        LogError("Corrupt Tanim binary timeline header. Can not deserialize.");
+        return false;
+    }
+
+    // === String Table ===
+    std::vector<std::string> strings{};
+    strings.reserve(string_count);
+    for (uint32_t str_idx = 0; str_idx < string_count && !reader.HasFailed(); ++str_idx)
+    {
+        const uint32_t length = reader.ReadU32();
+        strings.emplace_back(reader.ReadBytes(length));
+    }
+
+    auto read_string = [&reader, &strings]() -> const std::string&
+    {
+        static const std::string empty{};
+        const uint32_t str_idx = reader.ReadU32();
+        if (str_idx >= strings.size())
+        {
+            reader.Fail();
+            return empty;
+        }
+        return strings.at(str_idx);
+    };
+
+    // === Timeline ===
+    const std::string name = read_string();
+    const int first_frame = reader.ReadI32();
+    const int last_frame = reader.ReadI32();
+    const int min_frame = reader.ReadI32();
+    const int max_frame = reader.ReadI32();
+    const bool play_immediately = reader.ReadBool();
+    const int player_samples = reader.ReadI32();
+    const PlaybackType playback_type = ReadEnum(reader, PlaybackType::HOLD);
+
+    // === Sequences ===
+    std::vector<Sequence> sequences(sequence_count);
+    for (auto& seq : sequences)
+    {
+        const std::string& uid = read_string();
+        const std::string& display = read_string();
+        const std::string& struct_name = read_string();
+        const std::string& field_name = read_string();
+        seq.m_seq_id = SequenceId(EntityData{uid, display}, struct_name, field_name);
+
+        seq.m_type_meta = ReadEnum(reader, Sequence::TypeMeta::NONE);
+        seq.m_representation_meta = ReadEnum(reader, RepresentationMeta::NONE);
+        seq.m_last_frame = reader.ReadI32();
+        seq.m_first_frame = reader.ReadI32();
+
+        const uint32_t curve_count = reader.ReadU32();
+        if (curve_count > reader.GetRemaining() / kCurveBytes) reader.Fail();
+        if (reader.HasFailed()) break;
+
+        seq.m_curves.resize(curve_count);
+        for (auto& curve : seq.m_curves)
+        {
+            curve.m_name = read_string();
+            curve.m_handle_type_locked = reader.ReadBool();
+            curve.m_curve_handle_type = ReadEnum(reader, CurveHandleType::UNCONSTRAINED);
+
+            const uint32_t keyframe_count = reader.ReadU32();
+            if (keyframe_count > reader.GetRemaining() / kKeyframeBytes) reader.Fail();
+            if (reader.HasFailed()) break;
+
+            curve.m_keyframes.reserve(keyframe_count);
+            for (uint32_t k = 0; k < keyframe_count; ++k)
+            {
+                const float time = reader.ReadF32();
+                const float value = reader.ReadF32();
+                Keyframe& kf = curve.m_keyframes.emplace_back(time, value);
+                kf.m_handle_type = ReadEnum(reader, HandleType::SMOOTH);
+                ReadHandle(reader, kf.m_in);
+                ReadHandle(reader, kf.m_out);
+            }
+
+            CompileCurve(curve);
+        }
+    }
+
+    if (reader.HasFailed())
+    {
+        LogError("Truncated or corrupt Tanim binary timeline. Can not deserialize.");
+        return false;
+    }
+
+    // only touches data once everything was read, so a corrupt file leaves it unchanged
+    data.m_name = name;
+    data.m_first_frame = first_frame;
+    data.m_last_frame = last_frame;
+    data.m_min_frame = min_frame;
+    data.m_max_frame = max_frame;
+    data.m_play_immediately = play_immediately;
+    data.m_player_samples = player_samples;
+    data.m_playback_type = playback_type;
+    data.m_sequences = std::move(sequences);
+
+    Timeline::RefreshTimelineLastFrame(data);
+    Timeline::InvalidateBindings(data);
+    return true;
+}
+
+}  // namespace tanim
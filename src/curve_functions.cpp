@@ -3,6 +3,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <iterator>
 
 namespace tanim
 {
@@ -50,43 +52,135 @@ void ApplyCurveHandleTypeOnCurve(Curve& curve)
     }
 }
 
+// Sets the handle types curve_handle_type stands for, without resolving (see ApplyCurveHandleTypeOnKeyframe)
+static void SetHandleTypesOfCurveHandleType(Keyframe& key, CurveHandleType curve_handle_type)
+{
+    auto set_smooth = [&key](Handle::SmoothType type)
+    {
+        key.m_handle_type = HandleType::SMOOTH;
+        key.m_in.m_smooth_type = type;
+        key.m_out.m_smooth_type = type;
+        key.m_in.m_broken_type = Handle::BrokenType::UNUSED;
+        key.m_out.m_broken_type = Handle::BrokenType::UNUSED;
+    };
+    auto set_broken = [&key](Handle::BrokenType type)
+    {
+        key.m_handle_type = HandleType::BROKEN;
+        key.m_in.m_broken_type = type;
+        key.m_out.m_broken_type = type;
+        key.m_in.m_smooth_type = Handle::SmoothType::UNUSED;
+        key.m_out.m_smooth_type = Handle::SmoothType::UNUSED;
+    };
+
+    switch (curve_handle_type)
+    {
+        case CurveHandleType::UNCONSTRAINED:
+            break;
+        case CurveHandleType::AUTO:
+            set_smooth(Handle::SmoothType::AUTO);
+            break;
+        case CurveHandleType::FLAT:
+            set_smooth(Handle::SmoothType::FLAT);
+            break;
+        case CurveHandleType::LINEAR:
+            set_broken(Handle::BrokenType::LINEAR);
+            break;
+        case CurveHandleType::CONSTANT:
+            set_broken(Handle::BrokenType::CONSTANT);
+            break;
+        default:
+            assert(0 && "unhandled enforced type");
+    }
+}
+
 // === Keyframe Management ===
 
 int AddKeyframe(Curve& curve, float time, float value)
 {
     auto& keyframes = curve.m_keyframes;
 
-    // Find insertion position and check for duplicates
-    int insert_idx = (int)keyframes.size();
-    for (int i = 0; i < (int)keyframes.size(); i++)
+    // Find insertion position (keyframes are sorted by time) and check for duplicates on both sides
+    const auto it = std::lower_bound(keyframes.begin(),
+                                     keyframes.end(),
+                                     time,
+                                     [](const Keyframe& keyframe, float t) { return keyframe.Time() < t; });
+    const int insert_idx = static_cast<int>(it - keyframes.begin());
+
+    if (insert_idx < (int)keyframes.size() && std::abs(keyframes.at(insert_idx).Time() - time) < 1e-6f)
     {
-        if (std::abs(keyframes.at(i).Time() - time) < 1e-6f)
-        {
-            return -1;  // Duplicate
-        }
-        if (time < keyframes.at(i).Time())
-        {
-            insert_idx = i;
-            break;
-        }
+        return -1;  // Duplicate
+    }
+    if (insert_idx > 0 && std::abs(keyframes.at(insert_idx - 1).Time() - time) < 1e-6f)
+    {
+        return -1;  // Duplicate
     }
 
     const Keyframe new_key(time, value);
 
     // Insert
     keyframes.insert(keyframes.begin() + insert_idx, new_key);
+    InsertRuntimeKeyframe(curve.m_runtime, insert_idx);
 
     if (curve.m_handle_type_locked)
     {
         ApplyCurveHandleTypeOnKeyframe(curve, insert_idx);
     }
 
-    // Resolve all handles (AUTO handles need neighbor info)
-    ResolveCurveHandles(curve);
+    // Resolve the new keyframe and its neighbours (AUTO handles need neighbor info)
+    ResolveKeyframeRange(curve, insert_idx, insert_idx);
 
     return insert_idx;
 }
 
+int AddKeyframes(Curve& curve, std::span<const std::pair<float, float>> keys)
+{
+    auto& keyframes = curve.m_keyframes;
+    auto by_time = [](const Keyframe& a, const Keyframe& b) { return a.Time() < b.Time(); };
+
+    // Sort the new keys once. Stable, so the first of equal times stays first for the dedupe
+    std::vector<Keyframe> new_keys{};
+    new_keys.reserve(keys.size());
+    for (const auto& [time, value] : keys) new_keys.emplace_back(time, value);
+    std::stable_sort(new_keys.begin(), new_keys.end(), by_time);
+
+    // Dedupe against each other and against the existing keyframes, with the same tolerance as AddKeyframe
+    const size_t old_count = keyframes.size();
+    auto is_duplicate = [&keyframes, old_count](float time)
+    {
+        const auto old_end = keyframes.begin() + static_cast<std::ptrdiff_t>(old_count);
+        const auto it = std::lower_bound(keyframes.begin(),
+                                         old_end,
+                                         time,
+                                         [](const Keyframe& keyframe, float t) { return keyframe.Time() < t; });
+        if (it != old_end && std::abs(it->Time() - time) < 1e-6f) return true;
+        return it != keyframes.begin() && std::abs(std::prev(it)->Time() - time) < 1e-6f;
+    };
+
+    keyframes.reserve(old_count + new_keys.size());
+    for (size_t i = 0; i < new_keys.size(); i++)
+    {
+        const float time = new_keys.at(i).Time();
+        const bool repeated = keyframes.size() > old_count && std::abs(keyframes.back().Time() - time) < 1e-6f;
+        if (repeated || is_duplicate(time)) continue;
+
+        Keyframe& key = keyframes.emplace_back(new_keys.at(i));
+        if (curve.m_handle_type_locked)
+        {
+            SetHandleTypesOfCurveHandleType(key, curve.m_curve_handle_type);
+        }
+    }
+
+    const int added = static_cast<int>(keyframes.size() - old_count);
+    if (added == 0) return 0;
+
+    // Both halves are sorted, merge them and resolve everything once
+    const auto old_end = keyframes.begin() + static_cast<std::ptrdiff_t>(old_count);
+    std::inplace_merge(keyframes.begin(), old_end, keyframes.end(), by_time);
+    ResolveCurveHandles(curve);
+
+    return added;
+}
+
 bool RemoveKeyframe(Curve& curve, int keyframe_index)
 {
     const int count = GetKeyframeCount(curve);
@@ -95,9 +189,10 @@ bool RemoveKeyframe(Curve& curve, int keyframe_index)
     if (keyframe_index <= 0 || keyframe_index >= count - 1) return false;
 
     curve.m_keyframes.erase(curve.m_keyframes.begin() + keyframe_index);
+    EraseRuntimeKeyframe(curve.m_runtime, keyframe_index);
 
-    // Resolve handles for affected keyframes
-    ResolveCurveHandles(curve);
+    // Resolve handles for affected keyframes: the two that are neighbours now
+    ResolveKeyframeRange(curve, keyframe_index - 1, keyframe_index);
 
     return true;
 }
@@ -125,7 +220,7 @@ void MoveKeyframe(Curve& curve, int keyframe_index, ImVec2 new_pos)
     key.m_pos = new_pos;
 
     // Resolve handles (segment durations may have changed)
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index, keyframe_index);
 }
 
 // === Mode Changes ===
@@ -149,7 +244,7 @@ void SetKeyframeSmoothType(Curve& curve, int keyframe_index, Handle::SmoothType
         MirrorHandlesDir(key, true);  // out -> in
     }
 
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index, keyframe_index);
 }
 
 void SetKeyframeBrokenType(Curve& curve, int keyframe_index, Handle::BrokenType in_type, Handle::BrokenType out_type)
@@ -165,7 +260,7 @@ void SetKeyframeBrokenType(Curve& curve, int keyframe_index, Handle::BrokenType
     key.m_in.m_smooth_type = Handle::SmoothType::UNUSED;
     key.m_out.m_smooth_type = Handle::SmoothType::UNUSED;
 
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index, keyframe_index);
 }
 
 // === Individual Handle Changes ===
@@ -204,7 +299,7 @@ void SetInHandleBrokenType(Curve& curve, int keyframe_index, Handle::BrokenType
         prev.m_out.m_smooth_type = Handle::SmoothType::UNUSED;
     }
 
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index - 1, keyframe_index);
 }
 
 void SetOutHandleBrokenType(Curve& curve, int keyframe_index, Handle::BrokenType type)
@@ -241,7 +336,7 @@ void SetOutHandleBrokenType(Curve& curve, int keyframe_index, Handle::BrokenType
         next.m_in.m_smooth_type = Handle::SmoothType::UNUSED;
     }
 
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index, keyframe_index + 1);
 }
 
 void SetBothHandlesBrokenType(Curve& curve, int keyframe_index, Handle::BrokenType type)
@@ -270,7 +365,7 @@ void SetInHandleWeighted(Curve& curve, int keyframe_index, bool weighted)
     if (keyframe_index <= 0 || keyframe_index >= count) return;
 
     curve.m_keyframes.at(keyframe_index).m_in.m_weighted = weighted;
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index, keyframe_index);
 }
 
 void SetOutHandleWeighted(Curve& curve, int keyframe_index, bool weighted)
@@ -279,7 +374,7 @@ void SetOutHandleWeighted(Curve& curve, int keyframe_index, bool weighted)
     if (keyframe_index < 0 || keyframe_index >= count - 1) return;
 
     curve.m_keyframes.at(keyframe_index).m_out.m_weighted = weighted;
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index, keyframe_index);
 }
 
 void SetBothHandlesWeighted(Curve& curve, int keyframe_index, bool weighted)
@@ -299,7 +394,7 @@ void SetBothHandlesWeighted(Curve& curve, int keyframe_index, bool weighted)
         key.m_out.m_weighted = weighted;
     }
 
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index, keyframe_index);
 }
 
 // === Handle Manipulation ===
@@ -326,7 +421,7 @@ void SetInHandleOffset(Curve& curve, int keyframe_index, ImVec2 offset)
     key.m_in.m_offset = offset;
 
     // Resolve before mirroring to apply clamping handles
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index, keyframe_index);
 
     // If SMOOTH, mirror to out-handle
     if (key.m_handle_type == HandleType::SMOOTH)
@@ -334,7 +429,7 @@ void SetInHandleOffset(Curve& curve, int keyframe_index, ImVec2 offset)
         MirrorHandlesDir(key, false);  // in -> out
     }
 
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index, keyframe_index);
 }
 
 void SetOutHandleOffset(Curve& curve, int keyframe_index, ImVec2 offset)
@@ -359,7 +454,7 @@ void SetOutHandleOffset(Curve& curve, int keyframe_index, ImVec2 offset)
     key.m_out.m_offset = offset;
 
     // Resolve before mirroring to apply clamping handles
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index, keyframe_index);
 
     // If SMOOTH, mirror to in-handle
     if (key.m_handle_type == HandleType::SMOOTH)
@@ -367,7 +462,7 @@ void SetOutHandleOffset(Curve& curve, int keyframe_index, ImVec2 offset)
         MirrorHandlesDir(key, true);  // out -> in
     }
 
-    ResolveCurveHandles(curve);
+    ResolveKeyframeRange(curve, keyframe_index, keyframe_index);
 }
 
 // === Query Functions ===
@@ -0,0 +1,181 @@
+#include "tanim/include/tanim.hpp"
+
+#include "tanim/include/bezier.hpp"
+#include "tanim/include/curve_functions.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace tanim
+{
+
+namespace
+{
+
+int GetLutEntryCount(const RuntimeCurve& runtime, float step)
+{
+    if (runtime.m_times.size() < 2 || !(step > 0.0f)) return 0;
+    return static_cast<int>(std::ceil((runtime.m_times.back() - runtime.m_times.front()) / step)) + 1;
+}
+
+// the curve without its table
+RuntimeCurveView GetAnalyticView(const RuntimeCurve& runtime)
+{
+    return {runtime.m_times, runtime.m_values, runtime.m_segments};
+}
+
+}  // namespace
+
+// === Curve Tables ===
+
+int BakeCurveLut(Curve& curve, float step)
+{
+    RuntimeCurve& runtime = curve.m_runtime;
+    const int entry_count = GetLutEntryCount(runtime, step);
+    if (entry_count == 0)
+    {
+        ClearCurveLut(curve);
+        return 0;
+    }
+
+    const RuntimeCurveView analytic = GetAnalyticView(runtime);
+    const float start = runtime.m_times.front();
+
+    std::vector<float> values{};
+    values.reserve(entry_count);
+    int cursor = 0;
+    for (int entry = 0; entry < entry_count; ++entry)
+    {
+        values.push_back(SampleRuntimeCurve(analytic, start + static_cast<float>(entry) * step, cursor));
+    }
+
+    runtime.m_lut_values = std::move(values);
+    runtime.m_lut_start = start;
+    runtime.m_lut_inv_step = 1.0f / step;
+    return entry_count;
+}
+
+void ClearCurveLut(Curve& curve)
+{
+    curve.m_runtime.m_lut_values.clear();
+    curve.m_runtime.m_lut_values.shrink_to_fit();
+    curve.m_runtime.m_lut_start = 0.0f;
+    curve.m_runtime.m_lut_inv_step = 0.0f;
+}
+
+CurveLutReport MeasureCurveLutError(const Curve& curve)
+{
+    const RuntimeCurve& runtime = curve.m_runtime;
+    assert(!runtime.m_lut_values.empty());
+
+    CurveLutReport report{};
+    report.m_entries = static_cast<int>(runtime.m_lut_values.size());
+    report.m_bytes = runtime.m_lut_values.size() * sizeof(float);
+
+    const RuntimeCurveView analytic = GetAnalyticView(runtime);
+    const float step = 1.0f / runtime.m_lut_inv_step;
+
+    // lerp errors peak between the entries, so that is where it is measured
+    double error_sum = 0.0;
+    int sample_count = 0;
+    int cursor = 0;
+    for (int entry = 0; entry < report.m_entries - 1; ++entry)
+    {
+        for (const float fraction : {0.25f, 0.5f, 0.75f})
+        {
+            const float time = runtime.m_lut_start + (static_cast<float>(entry) + fraction) * step;
+            const float error = std::abs(SampleRuntimeLut(runtime, time) - SampleRuntimeCurve(analytic, time, cursor));
+            report.m_max_error = std::max(report.m_max_error, error);
+            error_sum += error;
+            sample_count++;
+        }
+    }
+
+    // right after a CONSTANT segment the lerp starts from the held value, so its error gets as large as the jump
+    for (size_t seg = 0; seg < runtime.m_segments.size(); ++seg)
+    {
+        if (!runtime.m_segments.at(seg).m_constant) continue;
+        const float jump = std::abs(runtime.m_values.at(seg + 1) - runtime.m_segments.at(seg).m_y.at(3));
+        report.m_max_error = std::max(report.m_max_error, jump);
+    }
+
+    if (sample_count > 0) report.m_mean_error = static_cast<float>(error_sum / sample_count);
+    return report;
+}
+
+// === Timeline Tables ===
+
+LutBakeReport Tanim::BakeTimelineLuts(TimelineData& tdata, const LutBakeSettings& settings)
+{
+    ClearTimelineLuts(tdata);
+
+    LutBakeReport report{};
+    const float step = 1.0f / static_cast<float>(std::max(settings.m_oversample, 1));
+
+    for (int seq_idx = 0; seq_idx < static_cast<int>(tdata.m_sequences.size()); ++seq_idx)
+    {
+        const Sequence& seq = tdata.m_sequences.at(seq_idx);
+
+        // quaternion sequences slerp between the keyframes of their component curves, they never sample them on their own
+        if (seq.m_representation_meta == RepresentationMeta::QUAT) continue;
+
+        for (int curve_idx = 0; curve_idx < static_cast<int>(seq.m_curves.size()); ++curve_idx)
+        {
+            const int entry_count = GetLutEntryCount(seq.m_curves.at(curve_idx).m_runtime, step);
+            if (entry_count == 0) continue;
+
+            CurveLutReport& curve_report = report.m_curves.emplace_back();
+            curve_report.m_seq_idx = seq_idx;
+            curve_report.m_curve_idx = curve_idx;
+            curve_report.m_entries = entry_count;
+            curve_report.m_bytes = entry_count * sizeof(float);
+            report.m_bytes_wanted += curve_report.m_bytes;
+        }
+    }
+
+    // smallest tables first, so the budget turns as many curves as possible into O(1) lookups
+    std::stable_sort(report.m_curves.begin(),
+                     report.m_curves.end(),
+                     [](const CurveLutReport& a, const CurveLutReport& b) { return a.m_bytes < b.m_bytes; });
+
+    for (auto& curve_report : report.m_curves)
+    {
+        if (report.m_bytes_used + curve_report.m_bytes > settings.m_memory_budget)
+        {
+            report.m_curves_skipped++;
+            continue;
+        }
+
+        Curve& curve = tdata.m_sequences.at(curve_report.m_seq_idx).m_curves.at(curve_report.m_curve_idx);
+        BakeCurveLut(curve, step);
+
+        const CurveLutReport measured = MeasureCurveLutError(curve);
+        curve_report.m_max_error = measured.m_max_error;
+        curve_report.m_mean_error = measured.m_mean_error;
+
+        if (settings.m_max_error >= 0.0f && measured.m_max_error > settings.m_max_error)
+        {
+            ClearCurveLut(curve);
+            report.m_curves_skipped++;
+            continue;
+        }
+
+        curve_report.m_baked = true;
+        report.m_bytes_used += curve_report.m_bytes;
+        report.m_curves_baked++;
+        report.m_max_error = std::max(report.m_max_error, measured.m_max_error);
+    }
+
+    return report;
+}
+
+void Tanim::ClearTimelineLuts(TimelineData& tdata)
+{
+    for (auto& seq : tdata.m_sequences)
+    {
+        for (auto& curve : seq.m_curves) ClearCurveLut(curve);
+    }
+}
+
+}  // namespace tanim
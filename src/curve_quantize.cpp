@@ -0,0 +1,244 @@
+#include "tanim/include/curve_quantize.hpp"
+
+#include "tanim/include/bezier.hpp"
+#include "tanim/include/profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace tanim
+{
+
+namespace
+{
+
+constexpr float kQuantizeSteps = 65535.0f;
+
+uint16_t QuantizeStep(float value, float min, float step)
+{
+    if (!(step > 0.0f)) return 0;
+    return static_cast<uint16_t>(std::clamp(std::round((value - min) / step), 0.0f, kQuantizeSteps));
+}
+
+uint16_t QuantizeFraction(float fraction)
+{
+    return static_cast<uint16_t>(std::round(std::clamp(fraction, 0.0f, 1.0f) * kQuantizeSteps));
+}
+
+float DecodeStep(uint16_t quantized, float min, float step) { return min + static_cast<float>(quantized) * step; }
+
+float DecodeFraction(uint16_t quantized) { return static_cast<float>(quantized) / kQuantizeSteps; }
+
+// first and step of the 16-bit steps covering [min, max]
+void MakeRange(float min, float max, float& out_min, float& out_step)
+{
+    out_min = min;
+    out_step = max > min ? (max - min) / kQuantizeSteps : 0.0f;
+}
+
+// the keyframes of segment seg decoded, compiled the way BakeRuntimeCurve compiles them
+CompiledSegment DecodeSegment(const QuantizedCurveView& curve, int seg)
+{
+    const QuantizedRange& range = curve.m_range;
+    const QuantizedKey& q0 = curve.m_keys[seg];
+    const QuantizedKey& q1 = curve.m_keys[seg + 1];
+    const float duration = static_cast<float>(q1.m_frame - q0.m_frame);
+
+    Keyframe k0{static_cast<float>(q0.m_frame), DecodeStep(q0.m_value, range.m_value_min, range.m_value_step)};
+    Keyframe k1{static_cast<float>(q1.m_frame), DecodeStep(q1.m_value, range.m_value_min, range.m_value_step)};
+    k0.m_out.m_offset.x = DecodeFraction(q0.m_out_x) * duration;
+    k0.m_out.m_offset.y = DecodeStep(q0.m_out_y, range.m_offset_min, range.m_offset_step);
+    k1.m_in.m_offset.x = -DecodeFraction(q1.m_in_x) * duration;
+    k1.m_in.m_offset.y = DecodeStep(q1.m_in_y, range.m_offset_min, range.m_offset_step);
+
+    CompiledSegment segment = CompileSegment(k0, k1);
+    segment.m_constant = (q0.m_flags & kQuantizedConstant) != 0;
+    segment.m_flat = (q0.m_flags & kQuantizedFlat) != 0;
+    segment.m_analytic = (q0.m_flags & kQuantizedAnalytic) != 0;
+    segment.m_level = (q0.m_flags & kQuantizedLevel) != 0;
+    return segment;
+}
+
+float DecodeValue(const QuantizedCurveView& curve, int key)
+{
+    return DecodeStep(curve.m_keys[key].m_value, curve.m_range.m_value_min, curve.m_range.m_value_step);
+}
+
+// FindSegmentIndex on the keyframe frames: a time exactly on a keyframe belongs to the segment that ends there
+int FindQuantizedSegment(const QuantizedCurveView& curve, float time)
+{
+    const auto& keys = curve.m_keys;
+    const int count = static_cast<int>(keys.size());
+    const auto it = std::lower_bound(keys.begin(),
+                                     keys.end(),
+                                     time,
+                                     [](const QuantizedKey& key, float t) { return static_cast<float>(key.m_frame) < t; });
+    return std::clamp(static_cast<int>(it - keys.begin()) - 1, 0, count - 2);
+}
+
+}  // namespace
+
+// === Quantizing ===
+
+bool CanQuantizeCurve(const RuntimeCurveView& runtime)
+{
+    for (const float time : runtime.m_times)
+    {
+        if (time != std::floor(time) || std::abs(time) > static_cast<float>(std::numeric_limits<int32_t>::max() / 2))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+QuantizedCurve QuantizeCurve(const RuntimeCurve& runtime)
+{
+    assert(CanQuantizeCurve(runtime));
+
+    QuantizedCurve quantized{};
+    const int count = static_cast<int>(runtime.m_times.size());
+    if (count == 0) return quantized;
+
+    const auto [value_min, value_max] = std::minmax_element(runtime.m_values.begin(), runtime.m_values.end());
+    MakeRange(*value_min, *value_max, quantized.m_range.m_value_min, quantized.m_range.m_value_step);
+
+    // only the handles that shape a segment: not the in-handle of the first or the out-handle of the last keyframe
+    float offset_min = 0.0f;
+    float offset_max = 0.0f;
+    for (int k = 0; k < count; ++k)
+    {
+        if (k > 0) offset_min = std::min(offset_min, runtime.m_in_tangents.at(k).y);
+        if (k > 0) offset_max = std::max(offset_max, runtime.m_in_tangents.at(k).y);
+        if (k < count - 1) offset_min = std::min(offset_min, runtime.m_out_tangents.at(k).y);
+        if (k < count - 1) offset_max = std::max(offset_max, runtime.m_out_tangents.at(k).y);
+    }
+    MakeRange(offset_min, offset_max, quantized.m_range.m_offset_min, quantized.m_range.m_offset_step);
+
+    const QuantizedRange& range = quantized.m_range;
+    quantized.m_keys.reserve(count);
+    for (int k = 0; k < count; ++k)
+    {
+        QuantizedKey key{};
+        key.m_frame = static_cast<int32_t>(runtime.m_times.at(k));
+        key.m_value = QuantizeStep(runtime.m_values.at(k), range.m_value_min, range.m_value_step);
+
+        if (k > 0)
+        {
+            const float duration = runtime.m_times.at(k) - runtime.m_times.at(k - 1);
+            const ImVec2& in = runtime.m_in_tangents.at(k);
+            key.m_in_x = duration > 0.0f ? QuantizeFraction(-in.x / duration) : 0;
+            key.m_in_y = QuantizeStep(in.y, range.m_offset_min, range.m_offset_step);
+        }
+
+        if (k < count - 1)
+        {
+            const float duration = runtime.m_times.at(k + 1) - runtime.m_times.at(k);
+            const ImVec2& out = runtime.m_out_tangents.at(k);
+            key.m_out_x = duration > 0.0f ? QuantizeFraction(out.x / duration) : 0;
+            key.m_out_y = QuantizeStep(out.y, range.m_offset_min, range.m_offset_step);
+
+            const CompiledSegment& segment = runtime.m_segments.at(k);
+            key.m_flags = static_cast<uint8_t>((segment.m_constant ? kQuantizedConstant : 0) |
+                                               (segment.m_flat ? kQuantizedFlat : 0) |
+                                               (segment.m_analytic ? kQuantizedAnalytic : 0) |
+                                               (segment.m_level ? kQuantizedLevel : 0));
+        }
+
+        quantized.m_keys.push_back(key);
+    }
+    return quantized;
+}
+
+float MeasureQuantizeError(const QuantizedCurveView& quantized, const RuntimeCurveView& runtime, int samples_per_segment)
+{
+    const int per_segment = std::max(samples_per_segment, 1);
+    const RuntimeCurveView analytic{runtime.m_times, runtime.m_values, runtime.m_segments};
+
+    float max_error = 0.0f;
+    int cursor = 0;
+    int quantized_cursor = 0;
+    for (size_t seg = 0; seg < runtime.m_segments.size(); ++seg)
+    {
+        const float start = runtime.m_times[seg];
+        const float duration = runtime.m_times[seg + 1] - start;
+        for (int s = 0; s <= per_segment; ++s)
+        {
+            const float time = start + duration * static_cast<float>(s) / static_cast<float>(per_segment);
+            const float error = std::abs(SampleQuantizedCurve(quantized, time, quantized_cursor) -
+                                         SampleRuntimeCurve(analytic, time, cursor));
+            max_error = std::max(max_error, error);
+        }
+    }
+    return max_error;
+}
+
+// === Sampling ===
+
+float SampleQuantizedCurve(const QuantizedCurveView& curve, float time)
+{
+    int cursor = -1;
+    return SampleQuantizedCurve(curve, time, cursor);
+}
+
+float SampleQuantizedCurve(const QuantizedCurveView& curve, float time, int& cursor)
+{
+    TANIM_PROFILE_COUNT(ProfileCounter::CURVES_EVALUATED, 1);
+    const auto& keys = curve.m_keys;
+    const int count = static_cast<int>(keys.size());
+
+    if (count == 0) return 0.0f;
+    if (time <= static_cast<float>(keys.front().m_frame)) return DecodeValue(curve, 0);
+    if (time >= static_cast<float>(keys.back().m_frame)) return DecodeValue(curve, count - 1);
+
+    // Forward playback stays in the current segment or steps into the next one, see FindSegmentIndex
+    auto contains = [&keys](int seg, float t)
+    { return t <= static_cast<float>(keys[seg + 1].m_frame) && (t > static_cast<float>(keys[seg].m_frame) || seg == 0); };
+
+    int seg = -1;
+    if (cursor >= 0 && cursor < count - 1 && contains(cursor, time))
+    {
+        seg = cursor;
+    }
+    else if (cursor >= 0 && cursor + 1 < count - 1 && contains(cursor + 1, time))
+    {
+        seg = cursor + 1;
+    }
+    else
+    {
+        seg = FindQuantizedSegment(curve, time);
+    }
+    cursor = seg;
+
+    const CompiledSegment segment = DecodeSegment(curve, seg);
+    const float times[2]{static_cast<float>(keys[seg].m_frame), static_cast<float>(keys[seg + 1].m_frame)};
+    const float values[2]{DecodeValue(curve, seg), DecodeValue(curve, seg + 1)};
+    return SampleRuntimeSegment({times, values, std::span<const CompiledSegment>(&segment, 1)}, 0, time);
+}
+
+HoldSpan FindQuantizedHold(const QuantizedCurveView& curve, float time)
+{
+    const auto& keys = curve.m_keys;
+    if (keys.empty()) return FindRuntimeHold({}, time);
+
+    // the hold of the decoded segment, found on a runtime view of its two keyframes
+    const int seg = keys.size() > 1 ? FindQuantizedSegment(curve, time) : 0;
+    const int last = std::min(seg + 1, static_cast<int>(keys.size()) - 1);
+    const CompiledSegment segment = last > seg ? DecodeSegment(curve, seg) : CompiledSegment{};
+    const float times[2]{static_cast<float>(keys[seg].m_frame), static_cast<float>(keys[last].m_frame)};
+    const float values[2]{DecodeValue(curve, seg), DecodeValue(curve, last)};
+    const std::span<const CompiledSegment> segments(&segment, last > seg ? 1 : 0);
+    HoldSpan hold = FindRuntimeHold({std::span<const float>(times, last - seg + 1), values, segments}, time);
+
+    if (hold.m_end <= hold.m_begin) return hold;
+
+    // the view only knows this segment, so a hold may only run on before and after it if the curve really ends there.
+    // a held inner segment holds up to and including its last keyframe
+    if (seg > 0) hold.m_begin = std::max(hold.m_begin, times[0]);
+    if (last < static_cast<int>(keys.size()) - 1) hold.m_end = time > times[0] ? times[1] : std::min(hold.m_end, times[1]);
+    return hold;
+}
+
+}  // namespace tanim
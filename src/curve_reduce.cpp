@@ -0,0 +1,555 @@
+#include "tanim/include/tanim.hpp"
+
+#include "tanim/include/bezier.hpp"
+#include "tanim/include/curve_functions.hpp"
+#include "tanim/include/sequencer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+namespace tanim
+{
+
+namespace
+{
+
+// the value the field of a sequence gets for a curve value, see reflection::SetFieldValue
+float ToFieldValue(float value, Sequence::TypeMeta type_meta)
+{
+    switch (type_meta)
+    {
+        case Sequence::TypeMeta::INT:
+            return std::floor(value);
+        case Sequence::TypeMeta::BOOL:
+            return value >= 0.5f ? 1.0f : 0.0f;
+        case Sequence::TypeMeta::NONE:
+        default:
+            return value;
+    }
+}
+
+// the original curve, at m_per_segment times in every segment. the samples of keyframe k start at k * m_per_segment.
+// like in playback, the sample on a keyframe belongs to the segment that ends there (the held value after a CONSTANT)
+struct CurveSamples
+{
+    std::vector<float> m_times{};
+    std::vector<float> m_values{};  // field values
+    int m_per_segment{1};
+
+    int FirstOfKeyframe(int keyframe_idx) const { return keyframe_idx * m_per_segment; }
+};
+
+CurveSamples TakeSamples(const RuntimeCurve& original, int per_segment, Sequence::TypeMeta type_meta)
+{
+    CurveSamples samples{};
+    samples.m_per_segment = std::max(per_segment, 1);
+
+    const int segment_count = static_cast<int>(original.m_segments.size());
+    const RuntimeCurveView view{original.m_times, original.m_values, original.m_segments};
+    int cursor = 0;
+    for (int seg = 0; seg < segment_count; ++seg)
+    {
+        const float start = original.m_times.at(seg);
+        const float duration = original.m_times.at(seg + 1) - start;
+        for (int s = 0; s < samples.m_per_segment; ++s)
+        {
+            const float time = start + duration * static_cast<float>(s) / static_cast<float>(samples.m_per_segment);
+            samples.m_times.push_back(time);
+            samples.m_values.push_back(ToFieldValue(SampleRuntimeCurve(view, time, cursor), type_meta));
+        }
+    }
+    samples.m_times.push_back(original.m_times.back());
+    samples.m_values.push_back(ToFieldValue(original.m_values.back(), type_meta));
+    return samples;
+}
+
+// max error of runtime against the samples first to last (inclusive). stops early once it exceeds limit
+float MeasureError(const RuntimeCurveView& runtime,
+                   const CurveSamples& samples,
+                   int first,
+                   int last,
+                   Sequence::TypeMeta type_meta,
+                   float limit)
+{
+    float max_error = 0.0f;
+    int cursor = 0;
+    for (int s = first; s <= last; ++s)
+    {
+        const float value = ToFieldValue(SampleRuntimeCurve(runtime, samples.m_times.at(s), cursor), type_meta);
+        max_error = std::max(max_error, std::abs(value - samples.m_values.at(s)));
+        if (max_error > limit) break;
+    }
+    return max_error;
+}
+
+// the furthest keyframe after first that a single span from first can reach, up to limit. fits(first, first + 1) is
+// assumed, longer spans are probed with doubling steps, then narrowed down with a binary search
+template <typename FitsFunc>
+int FindSpanEnd(int first, int limit, const FitsFunc& fits)
+{
+    int good = first + 1;
+    int bad = limit + 1;
+    for (int step = 1; first + 1 + step <= limit; step *= 2)
+    {
+        const int probe = first + 1 + step;
+        if (!fits(first, probe))
+        {
+            bad = probe;
+            break;
+        }
+        good = probe;
+    }
+
+    while (bad - good > 1)
+    {
+        const int mid = (good + bad) / 2;
+        if (fits(first, mid))
+        {
+            good = mid;
+        }
+        else
+        {
+            bad = mid;
+        }
+    }
+    return good;
+}
+
+// === Unlocked Curves ===
+
+// the handles of one segment replacing the keyframes between two others
+struct SpanFit
+{
+    ImVec2 m_out_offset{};
+    ImVec2 m_in_offset{};
+    bool m_weighted{false};
+};
+
+float SlopeOf(const ImVec2& tangent) { return std::abs(tangent.x) > 1e-6f ? tangent.y / tangent.x : 0.0f; }
+
+// a cubic in x with control values 0, out_x, duration - in_x, duration only goes forward in time if its derivative,
+// a quadratic Bernstein polynomial with coefficients out_x, duration - out_x - in_x, in_x, never drops below zero
+bool IsMonotonic(float out_x, float in_x, float duration)
+{
+    const float middle = duration - out_x - in_x;
+    return middle >= 0.0f || middle * middle <= out_x * in_x;
+}
+
+std::optional<SpanFit> FitSpan(const Curve& curve,
+                               const RuntimeCurve& original,
+                               const CurveSamples& samples,
+                               int first,
+                               int last,
+                               float tolerance,
+                               Sequence::TypeMeta type_meta)
+{
+    const float times[2]{original.m_times.at(first), original.m_times.at(last)};
+    const float values[2]{original.m_values.at(first), original.m_values.at(last)};
+    const float duration = times[1] - times[0];
+    if (duration < 1e-6f) return std::nullopt;
+
+    // the tangents of the original curve at both ends, so the span joins its neighbours as smoothly as before
+    const float out_slope = SlopeOf(original.m_out_tangents.at(first));
+    const float in_slope = SlopeOf(original.m_in_tangents.at(last));
+
+    // the sample on keyframe first belongs to the segment before the span
+    const int first_sample = samples.FirstOfKeyframe(first) + 1;
+    const int last_sample = samples.FirstOfKeyframe(last);
+
+    Keyframe k0{times[0], values[0]};
+    Keyframe k1{times[1], values[1]};
+    CompiledSegment segment{};
+
+    auto error_of = [&](float out_x, float in_x, float limit)
+    {
+        k0.m_out.m_offset = ImVec2(out_x, out_x * out_slope);
+        k1.m_in.m_offset = ImVec2(-in_x, -in_x * in_slope);
+        segment = CompileSegment(k0, k1);
+        segment.m_analytic = curve.m_time_solver == TimeSolver::ANALYTIC;
+        const RuntimeCurveView view{times, values, std::span<const CompiledSegment>(&segment, 1)};
+        return MeasureError(view, samples, first_sample, last_sample, type_meta, limit);
+    };
+
+    auto make_fit = [&](float out_x, float in_x, bool weighted)
+    { return SpanFit{ImVec2(out_x, out_x * out_slope), ImVec2(-in_x, -in_x * in_slope), weighted}; };
+
+    // the default handle lengths first, what a FREE unweighted handle resolves to
+    const float default_x = duration / 3.0f;
+    float best_error = error_of(default_x, default_x, tolerance);
+    if (best_error <= tolerance) return make_fit(default_x, default_x, false);
+
+    // weighted handles: a grid of both lengths, then a few rounds around the best of it
+    constexpr int kGridSteps = 8;
+    float best_out = default_x;
+    float best_in = default_x;
+    float step = duration / static_cast<float>(kGridSteps);
+    for (int out_step = 1; out_step <= kGridSteps; ++out_step)
+    {
+        for (int in_step = 1; in_step <= kGridSteps; ++in_step)
+        {
+            const float out_x = step * static_cast<float>(out_step);
+            const float in_x = step * static_cast<float>(in_step);
+            if (!IsMonotonic(out_x, in_x, duration)) continue;
+
+            const float error = error_of(out_x, in_x, best_error);
+            if (error < best_error)
+            {
+                best_error = error;
+                best_out = out_x;
+                best_in = in_x;
+            }
+        }
+    }
+
+    for (int round = 0; round < 4 && best_error > tolerance; ++round)
+    {
+        step *= 0.5f;
+        const float center_out = best_out;
+        const float center_in = best_in;
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                const float out_x = center_out + step * static_cast<float>(dx);
+                const float in_x = center_in + step * static_cast<float>(dy);
+                if (out_x <= 0.0f || in_x <= 0.0f || out_x > duration || in_x > duration) continue;
+                if (!IsMonotonic(out_x, in_x, duration)) continue;
+
+                const float error = error_of(out_x, in_x, best_error);
+                if (error < best_error)
+                {
+                    best_error = error;
+                    best_out = out_x;
+                    best_in = in_x;
+                }
+            }
+        }
+    }
+
+    if (best_error > tolerance) return std::nullopt;
+    return make_fit(best_out, best_in, true);
+}
+
+// a kept keyframe next to a replaced span: AUTO and FLAT handles would be recalculated from the new neighbours,
+// so SMOOTH keyframes keep their resolved handles as FREE ones
+void FreezeHandles(Keyframe& keyframe)
+{
+    if (keyframe.m_handle_type != HandleType::SMOOTH) return;
+    keyframe.m_in.m_smooth_type = Handle::SmoothType::FREE;
+    keyframe.m_out.m_smooth_type = Handle::SmoothType::FREE;
+}
+
+void SetFittedHandle(Keyframe& keyframe, Handle& handle, const ImVec2& offset, bool weighted)
+{
+    FreezeHandles(keyframe);
+    handle.m_offset = offset;
+    handle.m_weighted = weighted;
+    if (keyframe.m_handle_type == HandleType::BROKEN) handle.m_broken_type = Handle::BrokenType::FREE;
+}
+
+std::vector<Keyframe> ReduceUnlockedCurve(const Curve& curve,
+                                          const RuntimeCurve& original,
+                                          const CurveSamples& samples,
+                                          float tolerance,
+                                          Sequence::TypeMeta type_meta)
+{
+    const auto& keyframes = curve.m_keyframes;
+    const int count = GetKeyframeCount(curve);
+
+    auto fits = [&](int first, int last)
+    { return FitSpan(curve, original, samples, first, last, tolerance, type_meta).has_value(); };
+
+    std::vector<Keyframe> reduced{keyframes.front()};
+    int first = 0;
+    while (first < count - 1)
+    {
+        // spans stop at CONSTANT segments, those are kept as they are
+        int limit = first + 1;
+        if (!original.m_segments.at(first).m_constant)
+        {
+            while (limit < count - 1 && !original.m_segments.at(limit).m_constant) limit++;
+        }
+
+        const int last = FindSpanEnd(first, limit, fits);
+        reduced.push_back(keyframes.at(last));
+
+        if (last > first + 1)
+        {
+            const SpanFit fit = FitSpan(curve, original, samples, first, last, tolerance, type_meta).value();
+            Keyframe& start = reduced.at(reduced.size() - 2);
+            Keyframe& end = reduced.back();
+            SetFittedHandle(start, start.m_out, fit.m_out_offset, fit.m_weighted);
+            SetFittedHandle(end, end.m_in, fit.m_in_offset, fit.m_weighted);
+        }
+        first = last;
+    }
+    return reduced;
+}
+
+// === Locked Curves ===
+
+// the resolved handles of a keyframe depend on its neighbours (AUTO on both, LINEAR on one), so removing keyframe k
+// changes the segments from the kept keyframe two before it to the keyframe two after it. every removal is checked
+// on a small curve of just those keyframes, plus one more on both sides for their AUTO slopes
+std::vector<Keyframe> ReduceLockedCurve(const Curve& curve,
+                                        const CurveSamples& samples,
+                                        float tolerance,
+                                        Sequence::TypeMeta type_meta)
+{
+    const auto& keyframes = curve.m_keyframes;
+    const int count = GetKeyframeCount(curve);
+
+    Curve window{};
+    window.m_curve_handle_type = curve.m_curve_handle_type;
+    window.m_handle_type_locked = true;
+    window.m_time_solver = curve.m_time_solver;
+
+    std::vector<int> kept{0};
+    for (int k = 1; k < count - 1; ++k)
+    {
+        const int kept_count = static_cast<int>(kept.size());
+
+        window.m_keyframes.clear();
+        for (int n = std::max(kept_count - 3, 0); n < kept_count; ++n) window.m_keyframes.push_back(keyframes.at(kept.at(n)));
+        for (int n = k + 1; n <= std::min(k + 3, count - 1); ++n) window.m_keyframes.push_back(keyframes.at(n));
+        ResolveCurveHandles(window);
+
+        const int first_sample = samples.FirstOfKeyframe(kept.at(std::max(kept_count - 2, 0)));
+        const int last_sample = samples.FirstOfKeyframe(std::min(k + 2, count - 1));
+        if (MeasureError(window.m_runtime, samples, first_sample, last_sample, type_meta, tolerance) <= tolerance) continue;
+
+        kept.push_back(k);
+    }
+    kept.push_back(count - 1);
+
+    std::vector<Keyframe> reduced{};
+    reduced.reserve(kept.size());
+    for (const int k : kept) reduced.push_back(keyframes.at(k));
+    return reduced;
+}
+
+// === Quaternion Sequences ===
+
+// rotation between two unit quaternions, in radians. from the chord length, which stays accurate for tiny angles
+float QuatAngle(const glm::quat& a, const glm::quat& b)
+{
+    const glm::quat na = glm::normalize(a);
+    glm::quat nb = glm::normalize(b);
+    if (glm::dot(na, nb) < 0.0f) nb = -nb;
+    const float dw = na.w - nb.w;
+    const float dx = na.x - nb.x;
+    const float dy = na.y - nb.y;
+    const float dz = na.z - nb.z;
+    const float chord = std::sqrt(dw * dw + dx * dx + dy * dy + dz * dz);
+    return 4.0f * std::asin(std::min(chord * 0.5f, 1.0f));
+}
+
+std::vector<CurveReduceReport> ReduceQuatSequence(Sequence& seq, const ReduceSettings& settings)
+{
+    constexpr int kQuatCurveCount = 5;  // W, X, Y, Z, Spins
+
+    std::vector<CurveReduceReport> reports(seq.m_curves.size());
+    for (int curve_idx = 0; curve_idx < static_cast<int>(reports.size()); ++curve_idx)
+    {
+        reports.at(curve_idx).m_curve_idx = curve_idx;
+        reports.at(curve_idx).m_keyframes_before = GetKeyframeCount(seq.m_curves.at(curve_idx));
+        reports.at(curve_idx).m_keyframes_after = reports.at(curve_idx).m_keyframes_before;
+    }
+
+    if (seq.GetCurveCount() != kQuatCurveCount) return reports;
+    const int count = GetKeyframeCount(seq.m_curves.at(0));
+    for (const auto& curve : seq.m_curves)
+    {
+        if (GetKeyframeCount(curve) != count) return reports;
+    }
+    if (count <= 2) return reports;
+
+    std::vector<RuntimeCurve> original{};
+    for (const auto& curve : seq.m_curves) original.push_back(BakeRuntimeCurve(curve));
+
+    auto sample_quat = [](const std::vector<RuntimeCurve>& runtimes, float time, int& cursor)
+    {
+        return sequencer::SampleQuatCurves(runtimes.at(0),
+                                           runtimes.at(1),
+                                           runtimes.at(2),
+                                           runtimes.at(3),
+                                           runtimes.at(4),
+                                           time,
+                                           cursor);
+    };
+    auto quat_at = [&original](int k)
+    {
+        return glm::quat(original.at(0).m_values.at(k),
+                         original.at(1).m_values.at(k),
+                         original.at(2).m_values.at(k),
+                         original.at(3).m_values.at(k));
+    };
+
+    const int per_segment = std::max(settings.m_samples_per_segment, 1);
+    std::vector<float> sample_times{};
+    std::vector<glm::quat> sample_quats{};
+    int cursor = 0;
+    for (int seg = 0; seg < count - 1; ++seg)
+    {
+        const float start = original.at(0).m_times.at(seg);
+        const float duration = original.at(0).m_times.at(seg + 1) - start;
+        for (int s = 0; s < per_segment; ++s)
+        {
+            sample_times.push_back(start + duration * static_cast<float>(s) / static_cast<float>(per_segment));
+            sample_quats.push_back(sample_quat(original, sample_times.back(), cursor));
+        }
+    }
+    sample_times.push_back(original.at(0).m_times.back());
+    sample_quats.push_back(quat_at(count - 1));
+
+    // one slerp from first to last, which SampleQuatCurves only does for LINEAR segments without spins
+    auto fits = [&](int first, int last)
+    {
+        const RuntimeCurve& curve_w = original.at(0);
+        const RuntimeCurve& curve_spins = original.at(4);
+        for (int seg = first; seg < last; ++seg)
+        {
+            if (curve_w.m_segments.at(seg).m_constant || curve_w.m_segments.at(seg).m_flat) return false;
+            if (static_cast<int>(curve_spins.m_values.at(seg + 1)) != 0) return false;
+        }
+
+        const float start = curve_w.m_times.at(first);
+        const float duration = curve_w.m_times.at(last) - start;
+        if (duration < 1e-6f) return false;
+
+        const glm::quat q_a = quat_at(first);
+        const glm::quat q_b = quat_at(last);
+        for (int s = first * per_segment + 1; s <= last * per_segment; ++s)
+        {
+            const float segment_t = (sample_times.at(s) - start) / duration;
+            if (QuatAngle(glm::slerp(q_a, q_b, segment_t, 0), sample_quats.at(s)) > settings.m_quat_tolerance) return false;
+        }
+        return true;
+    };
+
+    std::vector<int> kept{0};
+    while (kept.back() < count - 1) kept.push_back(FindSpanEnd(kept.back(), count - 1, fits));
+
+    for (auto& curve : seq.m_curves)
+    {
+        std::vector<Keyframe> reduced{};
+        reduced.reserve(kept.size());
+        for (const int k : kept) reduced.push_back(curve.m_keyframes.at(k));
+        curve.m_keyframes = std::move(reduced);
+        ResolveCurveHandles(curve);
+    }
+
+    std::vector<RuntimeCurve> result{};
+    for (const auto& curve : seq.m_curves) result.push_back(curve.m_runtime);
+
+    float max_error = 0.0f;
+    cursor = 0;
+    for (size_t s = 0; s < sample_times.size(); ++s)
+    {
+        max_error = std::max(max_error, QuatAngle(sample_quat(result, sample_times.at(s), cursor), sample_quats.at(s)));
+    }
+
+    for (auto& report : reports)
+    {
+        report.m_keyframes_after = static_cast<int>(kept.size());
+        report.m_compression_ratio = static_cast<float>(report.m_keyframes_before) / static_cast<float>(kept.size());
+        report.m_max_error = max_error;
+    }
+    return reports;
+}
+
+}  // namespace
+
+// === Curves ===
+
+CurveReduceReport ReduceCurve(Curve& curve, const ReduceSettings& settings, Sequence::TypeMeta type_meta)
+{
+    CurveReduceReport report{};
+    report.m_keyframes_before = GetKeyframeCount(curve);
+    report.m_keyframes_after = report.m_keyframes_before;
+    if (report.m_keyframes_before <= 2) return report;
+
+    // INT and BOOL fields only take whole values, any difference there is visible
+    const bool is_exact = type_meta == Sequence::TypeMeta::INT || type_meta == Sequence::TypeMeta::BOOL;
+    const float tolerance = is_exact ? 0.0f : settings.m_tolerance;
+
+    const RuntimeCurve original = BakeRuntimeCurve(curve);
+    const CurveSamples samples = TakeSamples(original, settings.m_samples_per_segment, type_meta);
+
+    const bool is_locked = curve.m_handle_type_locked && curve.m_curve_handle_type != CurveHandleType::UNCONSTRAINED;
+    std::vector<Keyframe> reduced = is_locked ? ReduceLockedCurve(curve, samples, tolerance, type_meta)
+                                              : ReduceUnlockedCurve(curve, original, samples, tolerance, type_meta);
+
+    std::vector<Keyframe> keyframes = std::move(curve.m_keyframes);
+    curve.m_keyframes = std::move(reduced);
+    ResolveCurveHandles(curve);
+
+    const int last_sample = static_cast<int>(samples.m_times.size()) - 1;
+    const float max_error =
+        MeasureError(curve.m_runtime, samples, 0, last_sample, type_meta, std::numeric_limits<float>::infinity());
+
+    // resolving the whole curve again rescales unweighted FREE handles, which may round a fitted span past the
+    // tolerance. never hand back a curve that is worse than asked for
+    if (max_error > tolerance * 1.01f)
+    {
+        curve.m_keyframes = std::move(keyframes);
+        ResolveCurveHandles(curve);
+        return report;
+    }
+
+    report.m_keyframes_after = GetKeyframeCount(curve);
+    report.m_compression_ratio = static_cast<float>(report.m_keyframes_before) / static_cast<float>(report.m_keyframes_after);
+    report.m_max_error = max_error;
+    return report;
+}
+
+std::vector<CurveReduceReport> ReduceSequence(Sequence& seq, const ReduceSettings& settings)
+{
+    if (seq.m_representation_meta == RepresentationMeta::QUAT) return ReduceQuatSequence(seq, settings);
+
+    std::vector<CurveReduceReport> reports{};
+    for (int curve_idx = 0; curve_idx < seq.GetCurveCount(); ++curve_idx)
+    {
+        CurveReduceReport& report = reports.emplace_back(ReduceCurve(seq.m_curves.at(curve_idx), settings, seq.m_type_meta));
+        report.m_curve_idx = curve_idx;
+    }
+    return reports;
+}
+
+// === Timelines ===
+
+ReduceReport Tanim::ReduceTimeline(TimelineData& tdata, const ReduceSettings& settings)
+{
+    ReduceReport report{};
+    for (int seq_idx = 0; seq_idx < static_cast<int>(tdata.m_sequences.size()); ++seq_idx)
+    {
+        Sequence& seq = tdata.m_sequences.at(seq_idx);
+        const bool is_quat = seq.m_representation_meta == RepresentationMeta::QUAT;
+
+        for (auto& curve_report : ReduceSequence(seq, settings))
+        {
+            curve_report.m_seq_idx = seq_idx;
+            report.m_keyframes_before += curve_report.m_keyframes_before;
+            report.m_keyframes_after += curve_report.m_keyframes_after;
+            if (is_quat)
+            {
+                report.m_max_quat_error = std::max(report.m_max_quat_error, curve_report.m_max_error);
+            }
+            else
+            {
+                report.m_max_error = std::max(report.m_max_error, curve_report.m_max_error);
+            }
+            report.m_curves.push_back(curve_report);
+        }
+    }
+
+    if (report.m_keyframes_after > 0)
+    {
+        report.m_compression_ratio = static_cast<float>(report.m_keyframes_before) / static_cast<float>(report.m_keyframes_after);
+    }
+    return report;
+}
+
+}  // namespace tanim
@@ -0,0 +1,519 @@
+#include "tanim/include/tanim.hpp"
+
+#include "tanim/include/curve_functions.hpp"
+#include "tanim/include/bezier.hpp"
+#include "tanim/include/user_override.hpp"
+
+#include <algorithm>
+#include <array>
+#include <istream>
+#include <span>
+#include <string_view>
+
+namespace tanim
+{
+
+namespace
+{
+
+// JSON objects of the version 2 schema, see Tanim::Serialize
+enum class Scope : uint8_t
+{
+    ROOT,
+    TIMELINE,
+    SEQUENCES,
+    SEQUENCE,
+    SEQ_ID,
+    ENTITY_DATA,
+    CURVES,
+    CURVE,
+    KEYFRAMES,
+    KEYFRAME,
+    HANDLE,
+    FLOAT_PAIR,  // [x, y] of m_pos and m_offset
+    SKIP,        // a value under a key the schema doesn't know
+};
+
+constexpr std::array<std::string_view, 9> kTimelineKeys{"m_name",
+                                                        "m_first_frame",
+                                                        "m_last_frame",
+                                                        "m_min_frame",
+                                                        "m_max_frame",
+                                                        "m_play_immediately",
+                                                        "m_player_samples",
+                                                        "m_playback_type",
+                                                        "m_sequences"};
+constexpr std::array<std::string_view, 6> kSequenceKeys{"m_seq_id",
+                                                        "m_type_meta",
+                                                        "m_representation_meta",
+                                                        "m_last_frame",
+                                                        "m_first_frame",
+                                                        "m_curves"};
+constexpr std::array<std::string_view, 3> kSeqIdKeys{"m_entity_data", "m_struct_name", "m_field_name"};
+constexpr std::array<std::string_view, 2> kEntityDataKeys{"m_uid", "m_display"};
+constexpr std::array<std::string_view, 4> kCurveKeys{"m_name", "m_handle_type_locked", "m_curve_handle_type", "m_keyframes"};
+constexpr std::array<std::string_view, 4> kKeyframeKeys{"m_pos", "m_handle_type", "m_in", "m_out"};
+constexpr std::array<std::string_view, 4> kHandleKeys{"m_offset", "m_weighted", "m_smooth_type", "m_broken_type"};
+
+/// keys that Deserialize reads with .at(), so they must all be present
+std::span<const std::string_view> GetRequiredKeys(Scope scope)
+{
+    switch (scope)
+    {
+        case Scope::TIMELINE: return kTimelineKeys;
+        case Scope::SEQUENCE: return kSequenceKeys;
+        case Scope::SEQ_ID: return kSeqIdKeys;
+        case Scope::ENTITY_DATA: return kEntityDataKeys;
+        case Scope::CURVE: return kCurveKeys;
+        case Scope::KEYFRAME: return kKeyframeKeys;
+        case Scope::HANDLE: return kHandleKeys;
+        default: return {};
+    }
+}
+
+struct Frame
+{
+    Scope m_scope{Scope::ROOT};
+    uint32_t m_seen_keys{0};  // bit per index in GetRequiredKeys
+    int m_element_count{0};
+    float* m_pair{nullptr};  // destination of a FLOAT_PAIR
+    int m_skip_depth{0};
+};
+
+/// one scalar JSON value, converted like nlohmann's get<T>() does
+struct Scalar
+{
+    enum class Kind : uint8_t
+    {
+        NUL,
+        BOOLEAN,
+        INTEGER,
+        UNSIGNED,
+        FLOAT,
+        STRING,
+    };
+
+    Kind m_kind{Kind::NUL};
+    bool m_boolean{false};
+    int64_t m_integer{0};
+    uint64_t m_unsigned{0};
+    double m_float{0};
+    const std::string* m_string{nullptr};
+
+    bool IsArithmetic() const { return m_kind != Kind::NUL && m_kind != Kind::STRING; }
+
+    double AsDouble() const
+    {
+        switch (m_kind)
+        {
+            case Kind::BOOLEAN: return m_boolean ? 1.0 : 0.0;
+            case Kind::INTEGER: return static_cast<double>(m_integer);
+            case Kind::UNSIGNED: return static_cast<double>(m_unsigned);
+            case Kind::FLOAT: return m_float;
+            default: return 0.0;
+        }
+    }
+
+    int AsInt() const
+    {
+        switch (m_kind)
+        {
+            case Kind::BOOLEAN: return m_boolean ? 1 : 0;
+            case Kind::INTEGER: return static_cast<int>(m_integer);
+            case Kind::UNSIGNED: return static_cast<int>(m_unsigned);
+            case Kind::FLOAT: return static_cast<int>(m_float);
+            default: return 0;
+        }
+    }
+};
+
+/// fills a TimelineData while the JSON is read, without building a DOM. see Tanim::DeserializeStream
+class TimelineSaxHandler
+{
+public:
+    using json = nlohmann::ordered_json;
+
+    // === SAX interface ===
+
+    bool null() { return OnScalar({}); }
+
+    bool boolean(bool value)
+    {
+        Scalar scalar{};
+        scalar.m_kind = Scalar::Kind::BOOLEAN;
+        scalar.m_boolean = value;
+        return OnScalar(scalar);
+    }
+
+    bool number_integer(json::number_integer_t value)
+    {
+        Scalar scalar{};
+        scalar.m_kind = Scalar::Kind::INTEGER;
+        scalar.m_integer = value;
+        return OnScalar(scalar);
+    }
+
+    bool number_unsigned(json::number_unsigned_t value)
+    {
+        Scalar scalar{};
+        scalar.m_kind = Scalar::Kind::UNSIGNED;
+        scalar.m_unsigned = value;
+        return OnScalar(scalar);
+    }
+
+    bool number_float(json::number_float_t value, const json::string_t& /*raw*/)
+    {
+        Scalar scalar{};
+        scalar.m_kind = Scalar::Kind::FLOAT;
+        scalar.m_float = value;
+        return OnScalar(scalar);
+    }
+
+    bool string(json::string_t& value)
+    {
+        Scalar scalar{};
+        scalar.m_kind = Scalar::Kind::STRING;
+        scalar.m_string = &value;
+        return OnScalar(scalar);
+    }
+
+    bool binary(json::binary_t& /*value*/) { return Fail("binary values are not part of the schema"); }
+
+    bool start_object(std::size_t /*size*/) { return OnContainer(true); }
+
+    bool key(json::string_t& name)
+    {
+        m_key = name;
+        Frame& frame = m_stack.back();
+        const auto required_keys = GetRequiredKeys(frame.m_scope);
+        for (size_t key_idx = 0; key_idx < required_keys.size(); ++key_idx)
+        {
+            if (required_keys[key_idx] == name) frame.m_seen_keys |= 1u << key_idx;
+        }
+        return true;
+    }
+
+    bool end_object()
+    {
+        if (m_stack.back().m_scope == Scope::SKIP) return EndSkip();
+        return EndFrame();
+    }
+
+    bool start_array(std::size_t /*size*/) { return OnContainer(false); }
+
+    bool end_array()
+    {
+        if (m_stack.back().m_scope == Scope::SKIP) return EndSkip();
+        return EndFrame();
+    }
+
+    bool parse_error(std::size_t /*position*/, const std::string& /*last_token*/, const nlohmann::detail::exception& ex)
+    {
+        return Fail(ex.what());
+    }
+
+    // === Results ===
+
+    TimelineData m_timeline{};
+    int m_version{1};  // same default as Deserialize: a missing version counts as 1
+    bool m_has_timeline{false};
+    std::string m_error{};
+
+private:
+    std::vector<Frame> m_stack{};
+    std::string m_key{};
+
+    Sequence* m_seq{nullptr};
+    Curve* m_curve{nullptr};
+    Keyframe* m_keyframe{nullptr};
+    Handle* m_handle{nullptr};
+    std::string m_uid{}, m_display{}, m_struct_name{}, m_field_name{};
+
+    bool Fail(const std::string& message)
+    {
+        if (m_error.empty()) m_error = message;
+        return false;
+    }
+
+    bool TypeError(const std::string& expected) { return Fail("'" + m_key + "' must be " + expected); }
+
+    bool Push(Scope scope, float* pair = nullptr)
+    {
+        Frame& frame = m_stack.emplace_back();
+        frame.m_scope = scope;
+        frame.m_pair = pair;
+        return true;
+    }
+
+    bool EndSkip()
+    {
+        if (--m_stack.back().m_skip_depth == 0) m_stack.pop_back();
+        return true;
+    }
+
+    bool OnContainer(bool is_object)
+    {
+        if (m_stack.empty())
+        {
+            if (!is_object) return Fail("the document must be an object");
+            return Push(Scope::ROOT);
+        }
+
+        Frame& frame = m_stack.back();
+        switch (frame.m_scope)
+        {
+            case Scope::SKIP: frame.m_skip_depth++; return true;
+            case Scope::SEQUENCES:
+                if (!is_object) return Fail("m_sequences may only hold objects");
+                m_seq = &m_timeline.m_sequences.emplace_back();
+                return Push(Scope::SEQUENCE);
+            case Scope::CURVES:
+                if (!is_object) return Fail("m_curves may only hold objects");
+                m_curve = &m_seq->m_curves.emplace_back();
+                return Push(Scope::CURVE);
+            case Scope::KEYFRAMES:
+                if (!is_object) return Fail("m_keyframes may only hold objects");
+                m_keyframe = &m_curve->m_keyframes.emplace_back();
+                return Push(Scope::KEYFRAME);
+            case Scope::FLOAT_PAIR:
+                if (frame.m_element_count++ < 2) return Fail("'" + m_key + "' must hold numbers");
+                return PushSkip();
+            default: break;
+        }
+
+        // a value inside an object, selected by its key
+        const std::string_view key = m_key;
+        auto expect = [&](bool object_expected, Scope scope, float* pair = nullptr)
+        { return is_object == object_expected ? Push(scope, pair) : TypeError(object_expected ? "an object" : "an array"); };
+
+        switch (frame.m_scope)
+        {
+            case Scope::ROOT:
+                if (key == "timeline_data")
+                {
+                    m_has_timeline = true;
+                    m_timeline.m_sequences.clear();
+                    return expect(true, Scope::TIMELINE);
+                }
+                break;
+            case Scope::TIMELINE:
+                if (key == "m_sequences")
+                {
+                    m_timeline.m_sequences.clear();
+                    return expect(false, Scope::SEQUENCES);
+                }
+                break;
+            case Scope::SEQUENCE:
+                if (key == "m_seq_id") return expect(true, Scope::SEQ_ID);
+                if (key == "m_curves")
+                {
+                    m_seq->m_curves.clear();
+                    return expect(false, Scope::CURVES);
+                }
+                break;
+            case Scope::SEQ_ID:
+                if (key == "m_entity_data") return expect(true, Scope::ENTITY_DATA);
+                break;
+            case Scope::CURVE:
+                if (key == "m_keyframes")
+                {
+                    m_curve->m_keyframes.clear();
+                    return expect(false, Scope::KEYFRAMES);
+                }
+                break;
+            case Scope::KEYFRAME:
+                if (key == "m_pos") return expect(false, Scope::FLOAT_PAIR, &m_keyframe->m_pos.x);
+                if (key == "m_in" || key == "m_out")
+                {
+                    m_handle = key == "m_in" ? &m_keyframe->m_in : &m_keyframe->m_out;
+                    return expect(true, Scope::HANDLE);
+                }
+                break;
+            case Scope::HANDLE:
+                if (key == "m_offset") return expect(false, Scope::FLOAT_PAIR, &m_handle->m_offset.x);
+                break;
+            default: break;
+        }
+
+        if (IsKnownKey(frame.m_scope, key)) return TypeError("a plain value");
+        return PushSkip();
+    }
+
+    bool PushSkip()
+    {
+        Push(Scope::SKIP);
+        m_stack.back().m_skip_depth = 1;
+        return true;
+    }
+
+    bool EndFrame()
+    {
+        const Frame frame = m_stack.back();
+        m_stack.pop_back();
+
+        const auto required_keys = GetRequiredKeys(frame.m_scope);
+        for (size_t key_idx = 0; key_idx < required_keys.size(); ++key_idx)
+        {
+            if ((frame.m_seen_keys & (1u << key_idx)) == 0)
+            {
+                return Fail("missing key '" + std::string(required_keys[key_idx]) + "'");
+            }
+        }
+
+        switch (frame.m_scope)
+        {
+            case Scope::FLOAT_PAIR:
+                if (frame.m_element_count < 2) return Fail("'" + m_key + "' must hold two numbers");
+                break;
+            case Scope::SEQ_ID: m_seq->m_seq_id = SequenceId(EntityData{m_uid, m_display}, m_struct_name, m_field_name); break;
+            case Scope::CURVE: CompileCurve(*m_curve); break;
+            default: break;
+        }
+        return true;
+    }
+
+    static bool IsKnownKey(Scope scope, std::string_view key)
+    {
+        if (scope == Scope::ROOT) return key == "version" || key == "timeline_data";
+        const auto keys = GetRequiredKeys(scope);
+        return std::find(keys.begin(), keys.end(), key) != keys.end();
+    }
+
+    bool OnScalar(const Scalar& scalar)
+    {
+        if (m_stack.empty()) return Fail("the document must be an object");
+
+        Frame& frame = m_stack.back();
+        const std::string_view key = m_key;
+
+        auto read_int = [&](int& out)
+        {
+            if (!scalar.IsArithmetic()) return TypeError("a number");
+            out = scalar.AsInt();
+            return true;
+        };
+        auto read_bool = [&](bool& out)
+        {
+            if (scalar.m_kind != Scalar::Kind::BOOLEAN) return TypeError("a boolean");
+            out = scalar.m_boolean;
+            return true;
+        };
+        auto read_string = [&](std::string& out)
+        {
+            if (scalar.m_kind != Scalar::Kind::STRING) return TypeError("a string");
+            out = *scalar.m_string;
+            return true;
+        };
+        auto read_enum = [&](auto& out, auto fallback)
+        {
+            if (scalar.m_kind != Scalar::Kind::STRING) return TypeError("a string");
+            out = magic_enum::enum_cast<std::decay_t<decltype(out)>>(*scalar.m_string).value_or(fallback);
+            return true;
+        };
+
+        switch (frame.m_scope)
+        {
+            case Scope::SKIP: return true;
+            case Scope::SEQUENCES:
+            case Scope::CURVES:
+            case Scope::KEYFRAMES: return Fail("arrays of the schema may only hold objects");
+            case Scope::FLOAT_PAIR:
+            {
+                const int element_idx = frame.m_element_count++;
+                if (element_idx >= 2) return true;
+                if (!scalar.IsArithmetic()) return TypeError("an array of numbers");
+                frame.m_pair[element_idx] = static_cast<float>(scalar.AsDouble());
+                return true;
+            }
+            case Scope::ROOT:
+                if (key == "version") return read_int(m_version);
+                break;
+            case Scope::TIMELINE:
+                if (key == "m_name") return read_string(m_timeline.m_name);
+                if (key == "m_first_frame") return read_int(m_timeline.m_first_frame);
+                if (key == "m_last_frame") return read_int(m_timeline.m_last_frame);
+                if (key == "m_min_frame") return read_int(m_timeline.m_min_frame);
+                if (key == "m_max_frame") return read_int(m_timeline.m_max_frame);
+                if (key == "m_play_immediately") return read_bool(m_timeline.m_play_immediately);
+                if (key == "m_player_samples") return read_int(m_timeline.m_player_samples);
+                if (key == "m_playback_type") return read_enum(m_timeline.m_playback_type, PlaybackType::HOLD);
+                break;
+            case Scope::SEQUENCE:
+                if (key == "m_type_meta") return read_enum(m_seq->m_type_meta, Sequence::TypeMeta::NONE);
+                if (key == "m_representation_meta") return read_enum(m_seq->m_representation_meta, RepresentationMeta::NONE);
+                if (key == "m_last_frame") return read_int(m_seq->m_last_frame);
+                if (key == "m_first_frame") return read_int(m_seq->m_first_frame);
+                break;
+            case Scope::SEQ_ID:
+                if (key == "m_struct_name") return read_string(m_struct_name);
+                if (key == "m_field_name") return read_string(m_field_name);
+                break;
+            case Scope::ENTITY_DATA:
+                if (key == "m_uid") return read_string(m_uid);
+                if (key == "m_display") return read_string(m_display);
+                break;
+            case Scope::CURVE:
+                if (key == "m_name") return read_string(m_curve->m_name);
+                if (key == "m_handle_type_locked") return read_bool(m_curve->m_handle_type_locked);
+                if (key == "m_curve_handle_type") return read_enum(m_curve->m_curve_handle_type, CurveHandleType::UNCONSTRAINED);
+                break;
+            case Scope::KEYFRAME:
+                if (key == "m_handle_type") return read_enum(m_keyframe->m_handle_type, HandleType::SMOOTH);
+                break;
+            case Scope::HANDLE:
+                if (key == "m_weighted") return read_bool(m_handle->m_weighted);
+                if (key == "m_smooth_type") return read_enum(m_handle->m_smooth_type, Handle::SmoothType::AUTO);
+                if (key == "m_broken_type") return read_enum(m_handle->m_broken_type, Handle::BrokenType::UNUSED);
+                break;
+        }
+
+        if (IsKnownKey(frame.m_scope, key)) return TypeError("an object or array");
+        return true;  // unknown keys are ignored, like Deserialize does
+    }
+};
+
+}  // namespace
+
+bool Tanim::DeserializeStream(TimelineData& data, std::istream& input)
+{
+    TANIM_PROFILE_SCOPE(ProfileScope::DESERIALIZE);
+
+    TimelineSaxHandler handler{};
+    const bool parsed = nlohmann::ordered_json::sax_parse(input, &handler);
+
+    if (!parsed || !handler.m_error.empty())
+    {
+        LogError("Couldn't deserialize timeline: " + (handler.m_error.empty() ? "invalid JSON" : handler.m_error));
+        return false;
+    }
+
+    if (handler.m_version < 2)
+    {
+        LogError("Versions prior to 2 are not supported. Can not deserialize.");
+        return false;
+    }
+
+    if (!handler.m_has_timeline)
+    {
+        LogError("Couldn't deserialize timeline: missing key 'timeline_data'");
+        return false;
+    }
+
+    // only touches data once the whole document was read, so an invalid document leaves it unchanged
+    TimelineData& loaded = handler.m_timeline;
+    data.m_name = std::move(loaded.m_name);
+    data.m_first_frame = loaded.m_first_frame;
+    data.m_last_frame = loaded.m_last_frame;
+    data.m_min_frame = loaded.m_min_frame;
+    data.m_max_frame = loaded.m_max_frame;
+    data.m_play_immediately = loaded.m_play_immediately;
+    data.m_player_samples = loaded.m_player_samples;
+    data.m_playback_type = loaded.m_playback_type;
+    data.m_sequences = std::move(loaded.m_sequences);
+
+    Timeline::RefreshTimelineLastFrame(data);
+    Timeline::InvalidateBindings(data);
+    return true;
+}
+
+}  // namespace tanim
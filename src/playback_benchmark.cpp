@@ -0,0 +1,305 @@
+#include "tanim/include/benchmark.hpp"
+
+#include "tanim/include/alloc_tracking.hpp"
+#include "tanim/include/curve_functions.hpp"
+#include "tanim/include/registry.hpp"
+#include "tanim/include/sequence.hpp"
+#include "tanim/include/sequencer.hpp"
+#include "tanim/include/tanim.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <sstream>
+
+namespace tanim
+{
+
+namespace
+{
+
+// every field type playback writes, see RunPlaybackBenchmark
+struct PlaybackBenchmarkComponent
+{
+    float m_float{0.0f};
+    int m_int{0};
+    bool m_bool{false};
+    glm::vec2 m_vec2{};
+    glm::vec3 m_vec3{};
+    glm::vec4 m_vec4{};
+    glm::quat m_quat{1.0f, 0.0f, 0.0f, 0.0f};
+};
+
+constexpr int kPlaybackBenchmarkFields = 7;
+
+}  // namespace
+
+}  // namespace tanim
+
+VISITABLE_STRUCT(tanim::PlaybackBenchmarkComponent, m_float, m_int, m_bool, m_vec2, m_vec3, m_vec4, m_quat);
+
+namespace tanim
+{
+
+namespace
+{
+
+// m_keyframes random keyframes on every curve of every sequence of tdata. quaternion keyframes are unit length
+void AddBenchmarkKeyframes(const PlaybackBenchmarkSettings& settings, TimelineData& tdata, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    const int key_count = std::max(settings.m_keyframes, 2);
+
+    std::vector<SequenceKeyframe> keys(key_count);
+    for (Sequence& seq : tdata.m_sequences)
+    {
+        for (int k = 0; k < key_count; ++k)
+        {
+            SequenceKeyframe& key = keys.at(k);
+            key.m_frame = static_cast<float>(k * settings.m_last_frame / (key_count - 1));
+            for (float& curve_value : key.m_value) curve_value = value(rng);
+            if (seq.m_representation_meta == RepresentationMeta::QUAT)
+            {
+                const glm::quat q = glm::normalize(glm::quat(key.m_value[0], key.m_value[1], key.m_value[2], key.m_value[3]));
+                key.m_value = {q.w, q.x, q.y, q.z};
+            }
+        }
+
+        // AddSequence made the first and last keyframes, AddKeyframes keeps those. give them the random values too
+        for (int curve_idx = 0; curve_idx < seq.GetCurveCount(); ++curve_idx)
+        {
+            Curve& curve = seq.m_curves.at(curve_idx);
+            const bool spins = seq.m_representation_meta == RepresentationMeta::QUAT && curve_idx == 4;
+            curve.m_keyframes.front().m_pos.y = spins ? 0.0f : keys.front().m_value.at(curve_idx);
+            curve.m_keyframes.back().m_pos.y = spins ? 0.0f : keys.back().m_value.at(curve_idx);
+        }
+        seq.AddKeyframes(std::span<const SequenceKeyframe>(keys));
+        for (Curve& curve : seq.m_curves) ResolveCurveHandles(curve);
+    }
+}
+
+// the generated scene and timeline of settings, bound and ready to play. shared by every benchmark of this file
+struct PlaybackBenchmarkScene
+{
+    Registry m_component_registry{};
+    entt::registry m_registry{};
+    std::vector<EntityData> m_entity_datas{};
+    std::vector<entt::entity> m_entities{};
+    TimelineData m_tdata{};
+    ComponentData m_cdata{};
+    int m_entity_count{0};
+    int m_seq_count{0};
+
+    explicit PlaybackBenchmarkScene(const PlaybackBenchmarkSettings& settings)
+    {
+        m_entity_count = std::max(settings.m_entities, 1);
+        m_seq_count = std::clamp(settings.m_sequences, 0, m_entity_count * kPlaybackBenchmarkFields);
+        std::mt19937 rng(settings.m_seed);
+
+        m_component_registry.RegisterComponent<PlaybackBenchmarkComponent>();
+        const RegisteredComponent& component = m_component_registry.GetComponents().at(0);
+
+        for (int e = 0; e < m_entity_count; ++e)
+        {
+            const std::string uid = "benchmark_" + std::to_string(e);
+            m_entity_datas.push_back({uid, uid});
+            m_entities.push_back(m_registry.create());
+            m_registry.emplace<PlaybackBenchmarkComponent>(m_entities.back());
+        }
+
+        m_tdata.m_last_frame = std::max(settings.m_last_frame, 1);
+        m_tdata.m_playback_type = PlaybackType::LOOP;
+
+        m_cdata.m_cached_entities_data = m_entity_datas;
+        for (int seq_idx = 0; seq_idx < m_seq_count; ++seq_idx)
+        {
+            const int entity_idx = seq_idx % m_entity_count;
+            const int field_idx = seq_idx / m_entity_count;
+            SequenceId seq_id(m_entity_datas.at(entity_idx), component.m_struct_name, component.m_field_names.at(field_idx));
+            reflection::AddSequence(m_registry.get<PlaybackBenchmarkComponent>(m_entities.at(entity_idx)), m_tdata, seq_id);
+            m_cdata.m_cached_entities.push_back(m_entities.at(entity_idx));
+            m_cdata.m_cached_writers.push_back(component.GetFieldWriter(field_idx));
+        }
+        AddBenchmarkKeyframes(settings, m_tdata, rng);
+
+        // bound like Tanim::BindTimeline does, with the entities created above
+        for (Sequence& seq : m_tdata.m_sequences)
+        {
+            component.BindField(seq);
+            sequencer::UpdateQuatTrack(seq);
+        }
+        m_cdata.m_holds.assign(m_seq_count, HoldSpan{});
+        m_cdata.m_hold_revisions.assign(m_seq_count, {});
+        m_cdata.m_bound_revision = m_tdata.m_bindings_revision;
+    }
+};
+
+// median of the times, in milliseconds, that repetitions calls of run took
+template <typename Run>
+double MedianMilliseconds(int repetitions, Run&& run)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<double> ms{};
+    for (int rep = 0; rep < std::max(repetitions, 1); ++rep)
+    {
+        const auto start = Clock::now();
+        run();
+        ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    std::sort(ms.begin(), ms.end());
+    return ms.at(ms.size() / 2);
+}
+
+}  // namespace
+
+// === Running ===
+
+PlaybackBenchmarkResult RunPlaybackBenchmark(const PlaybackBenchmarkSettings& settings)
+{
+    using Clock = std::chrono::steady_clock;
+
+    PlaybackBenchmarkScene scene(settings);
+    entt::registry& registry = scene.m_registry;
+    const std::vector<EntityData>& entity_datas = scene.m_entity_datas;
+    TimelineData& tdata = scene.m_tdata;
+    ComponentData& cdata = scene.m_cdata;
+    const int seq_count = scene.m_seq_count;
+
+    Tanim::StartTimeline(tdata, cdata);
+    Tanim::Play(cdata);
+    for (int tick = 0; tick < settings.m_warmup_ticks; ++tick)
+    {
+        Tanim::UpdateTimeline(registry, entity_datas, tdata, cdata, settings.m_delta_time);
+    }
+
+    // the host's counter, or tanim's own with TANIM_TRACK_ALLOCATIONS
+    std::function<int64_t()> allocation_counter = settings.m_allocation_counter;
+    if (!allocation_counter && kTrackAllocations) allocation_counter = &GetAllocationCount;
+
+    const int ticks = std::max(settings.m_ticks, 1);
+    const int64_t allocations_before = allocation_counter ? allocation_counter() : 0;
+    const auto start = Clock::now();
+    for (int tick = 0; tick < ticks; ++tick)
+    {
+        Tanim::UpdateTimeline(registry, entity_datas, tdata, cdata, settings.m_delta_time);
+    }
+    const double elapsed_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    const int64_t allocations_after = allocation_counter ? allocation_counter() : 0;
+
+    PlaybackBenchmarkResult result{};
+    result.m_entities = scene.m_entity_count;
+    result.m_sequences = seq_count;
+    result.m_ticks = ticks;
+    result.m_ns_per_tick = elapsed_ns / ticks;
+    result.m_ns_per_sequence_tick = seq_count > 0 ? result.m_ns_per_tick / seq_count : 0.0;
+    if (allocation_counter)
+    {
+        result.m_allocations_per_tick = static_cast<double>(allocations_after - allocations_before) / ticks;
+    }
+    return result;
+}
+
+SerializationBenchmarkResult RunSerializationBenchmark(const PlaybackBenchmarkSettings& settings, int repetitions)
+{
+    PlaybackBenchmarkScene scene(settings);
+    TimelineData& tdata = scene.m_tdata;
+
+    SerializationBenchmarkResult result{};
+    result.m_sequences = scene.m_seq_count;
+    result.m_keyframes = std::max(settings.m_keyframes, 2);
+
+    std::string json{};
+    result.m_json_save_ms = MedianMilliseconds(repetitions, [&] { json = Tanim::Serialize(tdata); });
+    result.m_json_bytes = static_cast<int64_t>(json.size());
+    result.m_json_load_ms = MedianMilliseconds(repetitions,
+                                               [&]
+                                               {
+                                                   TimelineData loaded{};
+                                                   Tanim::Deserialize(loaded, json);
+                                               });
+
+    std::vector<uint8_t> binary{};
+    result.m_binary_save_ms = MedianMilliseconds(repetitions, [&] { binary = Tanim::SerializeBinary(tdata); });
+    result.m_binary_bytes = static_cast<int64_t>(binary.size());
+    bool binary_loaded = true;
+    result.m_binary_load_ms = MedianMilliseconds(repetitions,
+                                                 [&]
+                                                 {
+                                                     TimelineData loaded{};
+                                                     binary_loaded = Tanim::DeserializeBinary(loaded, binary) && binary_loaded;
+                                                 });
+    if (!binary_loaded) result.m_binary_load_ms = -1.0;
+    return result;
+}
+
+// === Output ===
+
+std::string PlaybackBenchmarkResultsToJson(std::span<const PlaybackBenchmarkResult> results)
+{
+    nlohmann::json playback = nlohmann::json::array();
+    for (const PlaybackBenchmarkResult& result : results)
+    {
+        nlohmann::json result_js;
+        result_js["entities"] = result.m_entities;
+        result_js["sequences"] = result.m_sequences;
+        result_js["ticks"] = result.m_ticks;
+        result_js["ns_per_tick"] = result.m_ns_per_tick;
+        result_js["ns_per_sequence_tick"] = result.m_ns_per_sequence_tick;
+        result_js["allocations_per_tick"] = result.m_allocations_per_tick;
+        playback.push_back(result_js);
+    }
+
+    nlohmann::json json;
+    json["playback"] = playback;
+    return json.dump(2);
+}
+
+std::string PlaybackBenchmarkResultsToCsv(std::span<const PlaybackBenchmarkResult> results)
+{
+    std::ostringstream csv;
+    csv << "entities,sequences,ticks,ns_per_tick,ns_per_sequence_tick,allocations_per_tick\n";
+    for (const PlaybackBenchmarkResult& result : results)
+    {
+        csv << result.m_entities << ',' << result.m_sequences << ',' << result.m_ticks << ',' << result.m_ns_per_tick << ','
+            << result.m_ns_per_sequence_tick << ',' << result.m_allocations_per_tick << '\n';
+    }
+    return csv.str();
+}
+
+std::string SerializationBenchmarkResultsToJson(std::span<const SerializationBenchmarkResult> results)
+{
+    nlohmann::json serialization = nlohmann::json::array();
+    for (const SerializationBenchmarkResult& result : results)
+    {
+        nlohmann::json result_js;
+        result_js["sequences"] = result.m_sequences;
+        result_js["keyframes"] = result.m_keyframes;
+        result_js["json_bytes"] = result.m_json_bytes;
+        result_js["json_save_ms"] = result.m_json_save_ms;
+        result_js["json_load_ms"] = result.m_json_load_ms;
+        result_js["binary_bytes"] = result.m_binary_bytes;
+        result_js["binary_save_ms"] = result.m_binary_save_ms;
+        result_js["binary_load_ms"] = result.m_binary_load_ms;
+        serialization.push_back(result_js);
+    }
+
+    nlohmann::json json;
+    json["serialization"] = serialization;
+    return json.dump(2);
+}
+
+std::string SerializationBenchmarkResultsToCsv(std::span<const SerializationBenchmarkResult> results)
+{
+    std::ostringstream csv;
+    csv << "sequences,keyframes,json_bytes,json_save_ms,json_load_ms,binary_bytes,binary_save_ms,binary_load_ms\n";
+    for (const SerializationBenchmarkResult& result : results)
+    {
+        csv << result.m_sequences << ',' << result.m_keyframes << ',' << result.m_json_bytes << ',' << result.m_json_save_ms
+            << ',' << result.m_json_load_ms << ',' << result.m_binary_bytes << ',' << result.m_binary_save_ms << ','
+            << result.m_binary_load_ms << '\n';
+    }
+    return csv.str();
+}
+
+}  // namespace tanim
@@ -0,0 +1,146 @@
+#include "tanim/include/profiler.hpp"
+
+#include "tanim/include/includes.hpp"
+#include "tanim/include/timeline_data.hpp"
+
+#include <algorithm>
+
+namespace tanim
+{
+
+// === Stats ===
+
+Profiler::CounterSnapshot Profiler::GetCounters()
+{
+    CounterSnapshot snapshot{};
+    for (size_t counter_idx = 0; counter_idx < snapshot.size(); ++counter_idx)
+    {
+        snapshot.at(counter_idx) = m_counters.at(counter_idx).load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+void Profiler::AddScopeTime(ProfileScope scope, double ms)
+{
+    ProfileScopeStats& stats = m_scopes.at(static_cast<size_t>(scope));
+    stats.m_calls++;
+    stats.m_total_ms += ms;
+    stats.m_last_ms = ms;
+    stats.m_max_ms = std::max(stats.m_max_ms, ms);
+}
+
+void Profiler::AddTimelineUpdate(const TimelineData& tdata, const CounterSnapshot& before, double ms)
+{
+    auto it = std::find_if(m_timelines.begin(),
+                           m_timelines.end(),
+                           [&tdata](const TimelineStats& stats) { return stats.m_timeline == &tdata; });
+    if (it == m_timelines.end())
+    {
+        it = m_timelines.insert(m_timelines.end(), TimelineStats{&tdata});
+    }
+
+    TimelineStats& stats = *it;
+    stats.m_name = tdata.m_name;
+    stats.m_updates++;
+    stats.m_total_ms += ms;
+    stats.m_last_ms = ms;
+    stats.m_max_ms = std::max(stats.m_max_ms, ms);
+
+    const CounterSnapshot after = GetCounters();
+    for (size_t counter_idx = 0; counter_idx < after.size(); ++counter_idx)
+    {
+        stats.m_counters.at(counter_idx) += after.at(counter_idx) - before.at(counter_idx);
+    }
+}
+
+const TimelineStats* Profiler::FindTimelineStats(const TimelineData& tdata)
+{
+    const auto it = std::find_if(m_timelines.begin(),
+                                 m_timelines.end(),
+                                 [&tdata](const TimelineStats& stats) { return stats.m_timeline == &tdata; });
+    return it == m_timelines.end() ? nullptr : &*it;
+}
+
+void Profiler::Reset()
+{
+    for (auto& counter : m_counters) counter.store(0, std::memory_order_relaxed);
+    m_scopes.fill({});
+    m_timelines.clear();
+}
+
+// === Drawing ===
+
+void Profiler::Draw()
+{
+#ifndef TANIM_PROFILING
+    ImGui::TextWrapped("Define TANIM_PROFILING in the build to profile timelines.");
+#else
+    if (ImGui::Button("Reset"))
+    {
+        Reset();
+    }
+
+    if (ImGui::BeginTable("ProfilerScopes", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+    {
+        ImGui::TableSetupColumn("Scope");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Last ms");
+        ImGui::TableSetupColumn("Avg ms");
+        ImGui::TableSetupColumn("Max ms");
+        ImGui::TableHeadersRow();
+
+        for (size_t scope_idx = 0; scope_idx < m_scopes.size(); ++scope_idx)
+        {
+            const ProfileScopeStats& stats = m_scopes.at(scope_idx);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(magic_enum::enum_name(static_cast<ProfileScope>(scope_idx)).data());
+            ImGui::TableNextColumn();
+            ImGui::Text("%lld", static_cast<long long>(stats.m_calls));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.m_last_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.m_calls > 0 ? stats.m_total_ms / static_cast<double>(stats.m_calls) : 0.0);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.m_max_ms);
+        }
+        ImGui::EndTable();
+    }
+
+    // per update of each timeline, so timelines with many instances are compared by what one instance costs
+    if (ImGui::BeginTable("ProfilerTimelines", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
+    {
+        ImGui::TableSetupColumn("Timeline");
+        ImGui::TableSetupColumn("Updates");
+        ImGui::TableSetupColumn("Avg ms");
+        ImGui::TableSetupColumn("Sampled");
+        ImGui::TableSetupColumn("Curves");
+        ImGui::TableSetupColumn("Newton");
+        ImGui::TableSetupColumn("Skipped");
+        ImGui::TableHeadersRow();
+
+        for (const TimelineStats& stats : m_timelines)
+        {
+            const double updates = static_cast<double>(std::max<int64_t>(stats.m_updates, 1));
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(stats.m_name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%lld", static_cast<long long>(stats.m_updates));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.m_total_ms / updates);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", static_cast<double>(stats.Get(ProfileCounter::SEQUENCES_SAMPLED)) / updates);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", static_cast<double>(stats.Get(ProfileCounter::CURVES_EVALUATED)) / updates);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", static_cast<double>(stats.Get(ProfileCounter::NEWTON_ITERATIONS)) / updates);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", static_cast<double>(stats.Get(ProfileCounter::WRITES_SKIPPED)) / updates);
+        }
+        ImGui::EndTable();
+    }
+#endif
+}
+
+}  // namespace tanim
@@ -0,0 +1,158 @@
+#include "tanim/include/quat_track.hpp"
+
+#include "tanim/include/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tanim
+{
+
+namespace
+{
+
+// same test as glm::slerp: closer than this and sin theta is too small to divide by
+constexpr float kQuatLerpCosTheta = 1.0f - 1.1920929e-07f;
+
+constexpr float kPi = 3.14159265358979323846f;
+
+constexpr float kQuatUnitTolerance = 1e-4f;
+
+glm::quat Lerp(const glm::quat& a, const glm::quat& b, float t)
+{
+    return {a.w * (1.0f - t) + b.w * t, a.x * (1.0f - t) + b.x * t, a.y * (1.0f - t) + b.y * t, a.z * (1.0f - t) + b.z * t};
+}
+
+// FindSegmentIndex on the keyframe times: a time exactly on a keyframe belongs to the segment that ends there
+int FindQuatTrackSegment(const QuatTrack& track, float time)
+{
+    const auto& keys = track.m_keys;
+    const auto it = std::lower_bound(keys.begin(),
+                                     keys.end(),
+                                     time,
+                                     [](const QuatTrackKey& key, float t) { return key.m_time < t; });
+    return std::clamp(static_cast<int>(it - keys.begin()) - 1, 0, static_cast<int>(keys.size()) - 2);
+}
+
+}  // namespace
+
+// === Compiling ===
+
+QuatTrack CompileQuatTrack(const RuntimeCurveView& curve_w,
+                           const RuntimeCurveView& curve_x,
+                           const RuntimeCurveView& curve_y,
+                           const RuntimeCurveView& curve_z,
+                           const RuntimeCurveView& curve_spins)
+{
+    QuatTrack track{};
+    const int count = static_cast<int>(curve_w.m_times.size());
+    track.m_keys.resize(count);
+
+    for (int k = 0; k < count; ++k)
+    {
+        QuatTrackKey& key = track.m_keys.at(k);
+        key.m_time = curve_w.m_times[k];
+        key.m_quat = {curve_w.m_values[k], curve_x.m_values[k], curve_y.m_values[k], curve_z.m_values[k]};
+    }
+
+    for (int seg = 0; seg + 1 < count; ++seg)
+    {
+        QuatTrackKey& key = track.m_keys.at(seg);
+        const CompiledSegment& segment = curve_w.m_segments[seg];
+        const float duration = track.m_keys.at(seg + 1).m_time - key.m_time;
+
+        key.m_spins = static_cast<int16_t>(curve_spins.m_values[seg + 1]);
+        key.m_flat = segment.m_flat;
+        if (segment.m_constant || duration < 1e-6f)
+        {
+            key.m_mode = QuatSegmentMode::CONSTANT;
+            continue;
+        }
+        key.m_inv_duration = 1.0f / duration;
+
+        // the shorter way, exactly as glm::slerp picks it
+        key.m_target = track.m_keys.at(seg + 1).m_quat;
+        float cos_theta = glm::dot(key.m_quat, key.m_target);
+        if (cos_theta < 0.0f)
+        {
+            key.m_target = -key.m_target;
+            cos_theta = -cos_theta;
+        }
+
+        if (cos_theta > kQuatLerpCosTheta)
+        {
+            key.m_mode = QuatSegmentMode::LERP;
+            continue;
+        }
+
+        key.m_theta = std::acos(cos_theta);
+        key.m_phi = key.m_theta + static_cast<float>(key.m_spins) * kPi;
+        key.m_inv_sin_theta = 1.0f / std::sin(key.m_theta);
+        // nlerp ends up unit length, so it only stands in for slerp between unit keyframes
+        const bool unit = std::abs(glm::dot(key.m_quat, key.m_quat) - 1.0f) < kQuatUnitTolerance &&
+                          std::abs(glm::dot(key.m_target, key.m_target) - 1.0f) < kQuatUnitTolerance;
+        const bool nlerp = unit && key.m_spins == 0 && key.m_theta < kQuatNlerpMaxAngle;
+        key.m_mode = nlerp ? QuatSegmentMode::NLERP : QuatSegmentMode::SLERP;
+    }
+
+    return track;
+}
+
+// === Sampling ===
+
+glm::quat SampleQuatTrack(const QuatTrack& track, float time)
+{
+    int cursor = -1;
+    return SampleQuatTrack(track, time, cursor);
+}
+
+glm::quat SampleQuatTrack(const QuatTrack& track, float time, int& cursor)
+{
+    TANIM_PROFILE_COUNT(ProfileCounter::CURVES_EVALUATED, 4);
+    const auto& keys = track.m_keys;
+    const int count = static_cast<int>(keys.size());
+
+    if (count == 0) return {1.0f, 0.0f, 0.0f, 0.0f};
+    if (time <= keys.front().m_time) return keys.front().m_quat;
+    if (time >= keys.back().m_time) return keys.back().m_quat;
+
+    // Forward playback stays in the current segment or steps into the next one, see FindSegmentIndex
+    auto contains = [&keys](int seg, float t) { return t <= keys[seg + 1].m_time && (t > keys[seg].m_time || seg == 0); };
+
+    int seg = -1;
+    if (cursor >= 0 && cursor < count - 1 && contains(cursor, time))
+    {
+        seg = cursor;
+    }
+    else if (cursor >= 0 && cursor + 1 < count - 1 && contains(cursor + 1, time))
+    {
+        seg = cursor + 1;
+    }
+    else
+    {
+        seg = FindQuatTrackSegment(track, time);
+    }
+    cursor = seg;
+
+    const QuatTrackKey& key = keys[seg];
+    if (key.m_mode == QuatSegmentMode::CONSTANT) return key.m_quat;
+
+    float t = (time - key.m_time) * key.m_inv_duration;
+    if (key.m_flat)
+    {
+        t = t * t * (3.0f - 2.0f * t);
+    }
+
+    switch (key.m_mode)
+    {
+        case QuatSegmentMode::LERP:
+            return Lerp(key.m_quat, key.m_target, t);
+        case QuatSegmentMode::NLERP:
+            return glm::normalize(Lerp(key.m_quat, key.m_target, t));
+        default:
+            return (std::sin(key.m_theta - t * key.m_phi) * key.m_inv_sin_theta) * key.m_quat +
+                   (std::sin(t * key.m_phi) * key.m_inv_sin_theta) * key.m_target;
+    }
+}
+
+}  // namespace tanim
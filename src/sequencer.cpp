@@ -34,6 +34,7 @@
 #include "tanim/include/sequence.hpp"
 #include "tanim/include/tanim.hpp"
 
+#include <cmath>
 #include <cstdint>
 #include <set>
 #include <vector>
@@ -269,6 +270,8 @@ void SortEditPointByIndex(std::vector<EditPoint>& to_sort)
 
 int Edit(Sequence& seq, const ImVec2& size, unsigned int id, const ImRect* clipping_rect, ImVector<EditPoint>* selected_points)
 {
+    TANIM_PROFILE_SCOPE(ProfileScope::SEQUENCER_EDIT);
+
     static bool selecting_quad = false;
     static ImVec2 quad_selection;
     static int over_curve = -1;
@@ -1184,80 +1187,4 @@ int Edit(Sequence& seq, const ImVec2& size, unsigned int id, const ImRect* clipp
     return ret;
 }
 
-glm::quat SampleQuatForAnimation(Sequence& seq, float time)
-{
-    const Curve& curve_w = seq.m_curves.at(0);
-    const Curve& curve_x = seq.m_curves.at(1);
-    const Curve& curve_y = seq.m_curves.at(2);
-    const Curve& curve_z = seq.m_curves.at(3);
-    const Curve& curve_spins = seq.m_curves.at(4);
-
-    const int keyframe_count = GetKeyframeCount(curve_w);
-    if (keyframe_count == 0) return {1.0f, 0.0f, 0.0f, 0.0f};
-
-    // Before first keyframe
-    if (time <= curve_w.m_keyframes.at(0).Time())
-    {
-        return {curve_w.m_keyframes.at(0).Value(),
-                curve_x.m_keyframes.at(0).Value(),
-                curve_y.m_keyframes.at(0).Value(),
-                curve_z.m_keyframes.at(0).Value()};
-    }
-
-    // After last keyframe
-    if (time >= curve_w.m_keyframes.at(keyframe_count - 1).Time())
-    {
-        return {curve_w.m_keyframes.at(keyframe_count - 1).Value(),
-                curve_x.m_keyframes.at(keyframe_count - 1).Value(),
-                curve_y.m_keyframes.at(keyframe_count - 1).Value(),
-                curve_z.m_keyframes.at(keyframe_count - 1).Value()};
-    }
-
-    // Find segment
-    const int seg = FindSegmentIndex(curve_w, time);
-    if (seg < 0)
-    {
-        return {curve_w.m_keyframes.at(0).Value(),
-                curve_x.m_keyframes.at(0).Value(),
-                curve_y.m_keyframes.at(0).Value(),
-                curve_z.m_keyframes.at(0).Value()};
-    }
-
-    const Keyframe& k0 = curve_w.m_keyframes.at(seg);
-    const Keyframe& k1 = curve_w.m_keyframes.at(seg + 1);
-
-    const glm::quat q_a(curve_w.m_keyframes.at(seg).Value(),
-                        curve_x.m_keyframes.at(seg).Value(),
-                        curve_y.m_keyframes.at(seg).Value(),
-                        curve_z.m_keyframes.at(seg).Value());
-
-    const glm::quat q_b(curve_w.m_keyframes.at(seg + 1).Value(),
-                        curve_x.m_keyframes.at(seg + 1).Value(),
-                        curve_y.m_keyframes.at(seg + 1).Value(),
-                        curve_z.m_keyframes.at(seg + 1).Value());
-
-    const int spins = static_cast<int>(curve_spins.m_keyframes.at(seg + 1).Value());
-
-    // CONSTANT - step function
-    if (k0.m_handle_type == HandleType::BROKEN && k0.m_out.m_broken_type == Handle::BrokenType::CONSTANT)
-    {
-        return q_a;
-    }
-
-    const float segment_duration = k1.Time() - k0.Time();
-    if (segment_duration < 1e-6f) return q_a;
-
-    float segment_t = (time - k0.Time()) / segment_duration;
-
-    // FLAT - smoothstep easing
-    if (k0.m_handle_type == HandleType::SMOOTH && k0.m_out.m_smooth_type == Handle::SmoothType::FLAT)
-    {
-        segment_t = segment_t * segment_t * (3.0f - 2.0f * segment_t);
-    }
-
-    // LINEAR - use segment_t as-is
-
-    return glm::slerp(q_a, q_b, segment_t, spins);
-}
-
 }  // namespace tanim::sequencer
@@ -0,0 +1,190 @@
+#include "tanim/include/sequencer.hpp"
+
+#include "tanim/include/bezier.hpp"
+#include "tanim/include/profiler.hpp"
+#include "tanim/include/quat_track.hpp"
+#include "tanim/include/sequence.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace tanim::sequencer
+{
+
+// === Quaternion Playback ===
+// apart from the editor in sequencer.cpp, so playback code (e.g. the curve benchmarks) links without ImGui
+
+glm::quat SampleQuatForAnimation(const Sequence& seq, float time)
+{
+    int cursor = -1;
+    return SampleQuatForAnimation(seq, time, cursor);
+}
+
+glm::quat SampleQuatForAnimation(const Sequence& seq, float time, int& cursor)
+{
+    // Playback path: reads only the compiled track or the runtime curves
+    if (IsQuatTrackCurrent(seq))
+    {
+        return SampleQuatTrack(seq.m_quat_track, time, cursor);
+    }
+    return SampleQuatCurves(seq.m_curves.at(0).m_runtime,
+                            seq.m_curves.at(1).m_runtime,
+                            seq.m_curves.at(2).m_runtime,
+                            seq.m_curves.at(3).m_runtime,
+                            seq.m_curves.at(4).m_runtime,
+                            time,
+                            cursor);
+}
+
+bool IsQuatTrackCurrent(const Sequence& seq)
+{
+    const auto& revisions = seq.m_quat_track.m_revisions;
+    if (seq.GetCurveCount() < 5 || revisions.at(0) == 0) return false;
+
+    for (int curve_idx = 0; curve_idx < 5; ++curve_idx)
+    {
+        if (seq.m_curves.at(curve_idx).m_runtime.m_revision != revisions.at(curve_idx)) return false;
+    }
+    return true;
+}
+
+void UpdateQuatTrack(Sequence& seq)
+{
+    if (seq.m_representation_meta != RepresentationMeta::QUAT || seq.GetCurveCount() < 5 || IsQuatTrackCurrent(seq)) return;
+
+    // mid-edit the curves can disagree on their keyframes, playback stays on the curves until they match again
+    const size_t keyframe_count = seq.m_curves.at(0).m_runtime.m_times.size();
+    for (int curve_idx = 1; curve_idx < 5; ++curve_idx)
+    {
+        if (seq.m_curves.at(curve_idx).m_runtime.m_times.size() != keyframe_count)
+        {
+            seq.m_quat_track = {};
+            return;
+        }
+    }
+
+    seq.m_quat_track = CompileQuatTrack(seq.m_curves.at(0).m_runtime,
+                                        seq.m_curves.at(1).m_runtime,
+                                        seq.m_curves.at(2).m_runtime,
+                                        seq.m_curves.at(3).m_runtime,
+                                        seq.m_curves.at(4).m_runtime);
+    for (int curve_idx = 0; curve_idx < 5; ++curve_idx)
+    {
+        seq.m_quat_track.m_revisions.at(curve_idx) = seq.m_curves.at(curve_idx).m_runtime.m_revision;
+    }
+}
+
+// mid-edit the curves can disagree on their keyframes (see UpdateQuatTrack), and are indexed with the keyframes of W
+static bool AreQuatCurvesAligned(const RuntimeCurveView& curve_w,
+                                 const RuntimeCurveView& curve_x,
+                                 const RuntimeCurveView& curve_y,
+                                 const RuntimeCurveView& curve_z,
+                                 const RuntimeCurveView& curve_spins)
+{
+    const size_t keyframe_count = curve_w.m_times.size();
+    return curve_w.m_values.size() == keyframe_count && curve_x.m_values.size() == keyframe_count &&
+           curve_y.m_values.size() == keyframe_count && curve_z.m_values.size() == keyframe_count &&
+           curve_spins.m_values.size() == keyframe_count;
+}
+
+glm::quat SampleQuatCurves(const RuntimeCurveView& curve_w,
+                           const RuntimeCurveView& curve_x,
+                           const RuntimeCurveView& curve_y,
+                           const RuntimeCurveView& curve_z,
+                           const RuntimeCurveView& curve_spins,
+                           float time,
+                           int& cursor)
+{
+    TANIM_PROFILE_COUNT(ProfileCounter::CURVES_EVALUATED, 4);
+
+    const int keyframe_count = static_cast<int>(curve_w.m_times.size());
+    if (keyframe_count == 0 || !AreQuatCurvesAligned(curve_w, curve_x, curve_y, curve_z, curve_spins))
+    {
+        return {1.0f, 0.0f, 0.0f, 0.0f};
+    }
+
+    auto quat_at = [&](int k) -> glm::quat
+    { return {curve_w.m_values[k], curve_x.m_values[k], curve_y.m_values[k], curve_z.m_values[k]}; };
+
+    // Before first keyframe
+    if (time <= curve_w.m_times[0])
+    {
+        return quat_at(0);
+    }
+
+    // After last keyframe
+    if (time >= curve_w.m_times[keyframe_count - 1])
+    {
+        return quat_at(keyframe_count - 1);
+    }
+
+    // Find segment
+    const int seg = FindSegmentIndex(curve_w, time, cursor);
+    if (seg < 0)
+    {
+        return quat_at(0);
+    }
+
+    const CompiledSegment& segment = curve_w.m_segments[seg];
+
+    const glm::quat q_a = quat_at(seg);
+    const glm::quat q_b = quat_at(seg + 1);
+
+    const int spins = static_cast<int>(curve_spins.m_values[seg + 1]);
+
+    // CONSTANT - step function
+    if (segment.m_constant)
+    {
+        return q_a;
+    }
+
+    const float k0_time = curve_w.m_times[seg];
+    const float segment_duration = curve_w.m_times[seg + 1] - k0_time;
+    if (segment_duration < 1e-6f) return q_a;
+
+    float segment_t = (time - k0_time) / segment_duration;
+
+    // FLAT - smoothstep easing
+    if (segment.m_flat)
+    {
+        segment_t = segment_t * segment_t * (3.0f - 2.0f * segment_t);
+    }
+
+    // LINEAR - use segment_t as-is
+
+    return glm::slerp(q_a, q_b, segment_t, spins);
+}
+
+HoldSpan FindQuatHold(const RuntimeCurveView& curve_w,
+                      const RuntimeCurveView& curve_x,
+                      const RuntimeCurveView& curve_y,
+                      const RuntimeCurveView& curve_z,
+                      const RuntimeCurveView& curve_spins,
+                      float time,
+                      int& cursor)
+{
+    constexpr float kInf = std::numeric_limits<float>::infinity();
+    const auto& times = curve_w.m_times;
+    const int keyframe_count = static_cast<int>(times.size());
+
+    if (keyframe_count == 0) return {-kInf, kInf};
+    if (!AreQuatCurvesAligned(curve_w, curve_x, curve_y, curve_z, curve_spins)) return {};
+    if (time <= times[0]) return {-kInf, times[0]};
+    if (time >= times[keyframe_count - 1]) return {std::nextafter(times[keyframe_count - 1], -kInf), kInf};
+
+    const int seg = FindSegmentIndex(curve_w, time, cursor);
+    if (seg < 0) return {};
+
+    const bool constant = curve_w.m_segments[seg].m_constant;
+    const bool equal = curve_w.m_values[seg] == curve_w.m_values[seg + 1] && curve_x.m_values[seg] == curve_x.m_values[seg + 1] &&
+                       curve_y.m_values[seg] == curve_y.m_values[seg + 1] && curve_z.m_values[seg] == curve_z.m_values[seg + 1] &&
+                       static_cast<int>(curve_spins.m_values[seg + 1]) == 0;
+    if (!constant && !equal) return {};
+
+    // like FindRuntimeHold: the held value is the first keyframe for seg 0, and the last one for an equal last segment.
+    // a CONSTANT last segment stops just before the last keyframe
+    const float end = seg < keyframe_count - 2 ? times[seg + 1] : constant ? std::nextafter(times[seg + 1], -kInf) : kInf;
+    return {seg == 0 ? -kInf : times[seg], end};
+}
+
+}  // namespace tanim::sequencer
@@ -0,0 +1,109 @@
+#include "tanim/include/tanim.hpp"
+
+#include <algorithm>
+
+namespace tanim
+{
+
+// === Static Sequences ===
+
+bool IsRuntimeCurveStatic(const RuntimeCurveView& runtime)
+{
+    const auto& values = runtime.m_values;
+    if (!std::all_of(values.begin(), values.end(), [&values](float value) { return value == values.front(); })) return false;
+
+    return std::all_of(runtime.m_segments.begin(),
+                       runtime.m_segments.end(),
+                       [](const CompiledSegment& segment) { return segment.m_constant || segment.m_level; });
+}
+
+bool IsSequenceStatic(const Sequence& seq)
+{
+    if (seq.m_representation_meta == RepresentationMeta::QUAT)
+    {
+        // slerping between equal quaternions stays there, whatever the easing, unless it spins
+        for (int curve_idx = 0; curve_idx < 4; ++curve_idx)
+        {
+            const auto& values = seq.m_curves.at(curve_idx).m_runtime.m_values;
+            if (!std::all_of(values.begin(), values.end(), [&values](float value) { return value == values.front(); }))
+            {
+                return false;
+            }
+        }
+        const auto& spins = seq.m_curves.at(4).m_runtime.m_values;
+        return std::all_of(spins.begin(), spins.end(), [](float value) { return static_cast<int>(value) == 0; });
+    }
+
+    const int curve_count = std::min(seq.GetCurveCount(), static_cast<int>(SampledValue{}.size()));
+    for (int curve_idx = 0; curve_idx < curve_count; ++curve_idx)
+    {
+        if (!IsRuntimeCurveStatic(seq.m_curves.at(curve_idx).m_runtime)) return false;
+    }
+    return true;
+}
+
+bool IsStaticBakeCurrent(const Sequence& seq)
+{
+    if (!seq.m_static) return false;
+
+    const int curve_count = std::min(seq.GetCurveCount(), static_cast<int>(seq.m_static_revisions.size()));
+    for (int curve_idx = 0; curve_idx < curve_count; ++curve_idx)
+    {
+        if (seq.m_curves.at(curve_idx).m_runtime.m_revision != seq.m_static_revisions.at(curve_idx)) return false;
+    }
+    return true;
+}
+
+// === Timeline ===
+
+StaticBakeReport Tanim::BakeStaticSequences(TimelineData& tdata)
+{
+    StaticBakeReport report{};
+    tdata.m_static_sequences.clear();
+    tdata.m_dynamic_sequences.clear();
+
+    for (int seq_idx = 0; seq_idx < static_cast<int>(tdata.m_sequences.size()); ++seq_idx)
+    {
+        Sequence& seq = tdata.m_sequences.at(seq_idx);
+        seq.m_static = IsSequenceStatic(seq);
+        seq.m_static_revisions = {};
+        const int curve_count = std::min(seq.GetCurveCount(), static_cast<int>(seq.m_static_revisions.size()));
+        for (int curve_idx = 0; curve_idx < curve_count; ++curve_idx)
+        {
+            seq.m_static_revisions.at(curve_idx) = seq.m_curves.at(curve_idx).m_runtime.m_revision;
+        }
+        (seq.m_static ? tdata.m_static_sequences : tdata.m_dynamic_sequences).push_back(seq_idx);
+
+        SequenceStaticReport& seq_report = report.m_sequences.emplace_back();
+        seq_report.m_seq_idx = seq_idx;
+        seq_report.m_static = seq.m_static;
+        for (const auto& curve : seq.m_curves)
+        {
+            for (const auto& segment : curve.m_runtime.m_segments)
+            {
+                seq_report.m_segments++;
+                if (segment.m_constant) seq_report.m_constant_segments++;
+                else if (segment.m_level) seq_report.m_level_segments++;
+            }
+        }
+
+        if (seq.m_static) report.m_static_sequences++;
+        else report.m_dynamic_sequences++;
+        report.m_segments += seq_report.m_segments;
+        report.m_constant_segments += seq_report.m_constant_segments;
+        report.m_level_segments += seq_report.m_level_segments;
+    }
+
+    tdata.m_statics_revision = tdata.m_bindings_revision;
+    return report;
+}
+
+void Tanim::ClearStaticSequences(TimelineData& tdata)
+{
+    for (auto& seq : tdata.m_sequences) seq.m_static = false;
+    tdata.m_static_sequences.clear();
+    tdata.m_dynamic_sequences.clear();
+    tdata.m_statics_revision = -1;
+}
+
+}  // namespace tanim
@@ -8,6 +8,10 @@
 #include "tanim/include/sequence.hpp"
 #include "tanim/include/user_override.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <thread>
+
 namespace tanim
 {
 
@@ -23,6 +27,7 @@ void Tanim::UpdateEditor(float dt)
             ComponentData& cdata = *m_editor_component_data;
             if (Timeline::GetPlayerPlaying(cdata))
             {
+                TANIM_PROFILE_TIMELINE(tdata);
                 const bool has_passed_last_frame = Timeline::TickTime(tdata, cdata, dt);
                 Sample(*m_editor_registry, m_editor_entity_datas, tdata, cdata);
                 Timeline::CheckLooping(tdata, cdata, has_passed_last_frame);
@@ -40,6 +45,7 @@ void Tanim::OpenForEditing(entt::registry& registry,
     m_editor_registry = &registry;
     m_editor_entity_datas = entity_datas;
     m_editor_component_data = &component_data;
+    Timeline::InvalidateBindings(component_data);
 }
 
 void Tanim::CloseEditor()
@@ -55,26 +61,120 @@ void Tanim::Sample(entt::registry& registry,
                    TimelineData& tdata,
                    ComponentData& cdata)
 {
+    TANIM_PROFILE_SCOPE(ProfileScope::SAMPLE);
+
+    if (!Timeline::IsBound(tdata, cdata))
+    {
+        BindTimeline(entity_datas, tdata, cdata);
+    }
+
     const int player_frame = Timeline::GetPlayerFrame(tdata, cdata);
-    const float sample_time =
-        Timeline::GetPlayerPlaying(cdata) ? Timeline::GetPlayerSampleTime(tdata, cdata) : static_cast<float>(player_frame);
-    for (auto& seq : tdata.m_sequences)
+    const float sample_time = Timeline::GetSampleTime(tdata, cdata);
+    const int seq_count = Timeline::GetSequenceCount(tdata);
+    const bool skip_held = SkipsHeldSequences(tdata);
+    const bool statics = skip_held && Timeline::AreStaticsBaked(tdata);
+    SyncStaticHolds(statics, cdata);
+
+    auto sample_sequence = [&](int seq_idx)
     {
+        Sequence& seq = tdata.m_sequences.at(seq_idx);
         if (!seq.IsRecording() && seq.IsBetweenFirstAndLastFrame(player_frame))
         {
-            const auto* opt_comp = FindMatchingComponent(seq, entity_datas);
-            if (opt_comp)
+            const FieldWriter write = cdata.m_cached_writers.at(seq_idx);
+            const entt::entity entity = cdata.m_cached_entities.at(seq_idx);
+            const bool held = skip_held && IsHeld(seq, cdata, seq_idx, sample_time);
+            if (held) TANIM_PROFILE_COUNT(ProfileCounter::WRITES_SKIPPED, 1);
+            if (write && entity != entt::null && !held)
             {
-                const auto opt_entity = Timeline::FindEntity(cdata, seq);
-                if (opt_entity.has_value())
-                {
-                    opt_comp->m_sample(registry, opt_entity.value(), sample_time, seq);
-                }
+                write(registry, entity, seq.m_representation_meta, reflection::EvaluateSequence(seq, sample_time));
+                SetHold(seq, cdata, seq_idx, skip_held ? FindWriteHold(seq, statics, sample_time) : HoldSpan{});
             }
         }
+    };
+
+    // once every static sequence is written, only the dynamic ones are left to sample
+    if (statics && cdata.m_statics_applied)
+    {
+        for (const int seq_idx : tdata.m_dynamic_sequences) sample_sequence(seq_idx);
     }
+    else
+    {
+        for (int seq_idx = 0; seq_idx < seq_count; ++seq_idx) sample_sequence(seq_idx);
+        if (statics) UpdateStaticsApplied(tdata, cdata);
+    }
+}
+
+HoldSpan Tanim::FindWriteHold(const Sequence& seq, bool statics, float sample_time)
+{
+    if (seq.m_static && statics)
+    {
+        return {-std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()};
+    }
+    return reflection::FindSequenceHold(seq, sample_time);
+}
+
+bool Tanim::IsHeld(const Sequence& seq, const ComponentData& cdata, int seq_idx, float sample_time)
+{
+    return cdata.m_holds.at(seq_idx).Contains(sample_time) && cdata.m_hold_revisions.at(seq_idx) == seq.GetCurveRevisions();
 }
 
+void Tanim::SetHold(const Sequence& seq, ComponentData& cdata, int seq_idx, const HoldSpan& hold)
+{
+    cdata.m_holds.at(seq_idx) = hold;
+    cdata.m_hold_revisions.at(seq_idx) = seq.GetCurveRevisions();
+}
+
+void Tanim::UpdateStaticsApplied(const TimelineData& tdata, ComponentData& cdata)
+{
+    // static sequences hold forever once written, see FindWriteHold
+    cdata.m_statics_applied = std::all_of(tdata.m_static_sequences.begin(),
+                                          tdata.m_static_sequences.end(),
+                                          [&cdata](int seq_idx)
+                                          { return cdata.m_holds.at(seq_idx).m_end == std::numeric_limits<float>::infinity(); });
+}
+
+void Tanim::SyncStaticHolds(bool statics, ComponentData& cdata)
+{
+    if (statics)
+    {
+        cdata.m_static_holds = true;
+    }
+    else if (cdata.m_static_holds)
+    {
+        Timeline::InvalidateHolds(cdata);
+    }
+}
+
+void Tanim::BindTimeline(const std::vector<EntityData>& entity_datas, TimelineData& tdata, ComponentData& cdata)
+{
+    const int seq_count = Timeline::GetSequenceCount(tdata);
+
+    cdata.m_cached_entities_data = entity_datas;
+    cdata.m_cached_entities.assign(seq_count, entt::null);
+    cdata.m_cached_writers.assign(seq_count, nullptr);
+    cdata.m_holds.assign(seq_count, HoldSpan{});
+    cdata.m_hold_revisions.assign(seq_count, {});
+
+    for (int seq_idx = 0; seq_idx < seq_count; ++seq_idx)
+    {
+        Sequence& seq = tdata.m_sequences.at(seq_idx);
+        sequencer::UpdateQuatTrack(seq);  // so the thread-safe evaluations of UpdateTimelinesParallel find it compiled
+        const auto* opt_comp = FindMatchingComponent(seq, entity_datas);
+        if (opt_comp)
+        {
+            opt_comp->BindField(seq);
+            cdata.m_cached_writers.at(seq_idx) = opt_comp->GetFieldWriter(seq.m_field_index);
+            cdata.m_cached_entities.at(seq_idx) = Timeline::FindEntity(cdata, seq).value_or(entt::null);
+        }
+    }
+
+    cdata.m_bound_revision = tdata.m_bindings_revision;
+}
+
+void Tanim::InvalidateBindings(ComponentData& cdata) { Timeline::InvalidateBindings(cdata); }
+
+void Tanim::InvalidateHolds(ComponentData& cdata) { Timeline::InvalidateHolds(cdata); }
+
 void Tanim::SetEditorTimelinePlayerFrame(int frame_num)
 {
     if (m_editor_timeline_data)
@@ -87,6 +187,7 @@ void Tanim::SetEditorTimelinePlayerFrame(int frame_num)
 void Tanim::StartTimeline(const TimelineData& tdata, ComponentData& cdata)
 {
     Timeline::ResetPlayerTime(cdata);
+    Timeline::InvalidateHolds(cdata);
     if (Timeline::GetPlayImmediately(tdata))
     {
         Timeline::Play(cdata);
@@ -99,12 +200,300 @@ void Tanim::UpdateTimeline(entt::registry& registry,
                            ComponentData& cdata,
                            float delta_time)
 {
+    const AllocationScope allocations{};
+    const bool was_bound = Timeline::IsBound(tdata, cdata);
+
     if (Timeline::GetPlayerPlaying(cdata))
     {
+        TANIM_PROFILE_TIMELINE(tdata);
         const bool has_passed_last_frame = Timeline::TickTime(tdata, cdata, delta_time);
         Sample(registry, entity_datas, tdata, cdata);
         Timeline::CheckLooping(tdata, cdata, has_passed_last_frame);
     }
+
+    RecordUpdateAllocations(tdata, allocations.GetCount(), was_bound);
+}
+
+void Tanim::UpdateTimelines(entt::registry& registry,
+                            TimelineData& tdata,
+                            std::span<ComponentData> instances,
+                            float delta_time,
+                            bool snap_to_frames)
+{
+    const AllocationScope allocations{};
+    bool was_bound = false;
+    {
+        TANIM_PROFILE_TIMELINE(tdata);
+        was_bound = UpdateTimelinesImpl(registry, tdata, instances, delta_time, snap_to_frames, false);
+    }
+    RecordUpdateAllocations(tdata, allocations.GetCount(), was_bound);
+}
+
+void Tanim::UpdateTimelinesParallel(entt::registry& registry,
+                                    TimelineData& tdata,
+                                    std::span<ComponentData> instances,
+                                    float delta_time,
+                                    bool snap_to_frames)
+{
+    m_task_allocations = 0;
+    const AllocationScope allocations{};
+    bool was_bound = false;
+    {
+        TANIM_PROFILE_TIMELINE(tdata);
+        was_bound = UpdateTimelinesImpl(registry, tdata, instances, delta_time, snap_to_frames, true);
+    }
+    RecordUpdateAllocations(tdata, allocations.GetCount() + m_task_allocations, was_bound);
+}
+
+void Tanim::UpdateTimelineParallel(entt::registry& registry,
+                                   const std::vector<EntityData>& entity_datas,
+                                   TimelineData& tdata,
+                                   ComponentData& cdata,
+                                   float delta_time)
+{
+    m_task_allocations = 0;
+    const AllocationScope allocations{};
+    const bool was_bound = Timeline::IsBound(tdata, cdata);
+
+    if (Timeline::GetPlayerPlaying(cdata))
+    {
+        TANIM_PROFILE_TIMELINE(tdata);
+        if (!was_bound)
+        {
+            BindTimeline(entity_datas, tdata, cdata);
+        }
+        UpdateTimelinesImpl(registry, tdata, std::span<ComponentData>(&cdata, 1), delta_time, false, true);
+    }
+
+    RecordUpdateAllocations(tdata, allocations.GetCount() + m_task_allocations, was_bound);
+}
+
+void Tanim::RecordUpdateAllocations(const TimelineData& tdata, int64_t allocations, bool was_bound)
+{
+    m_last_update_allocations = allocations;
+
+    if (kTrackAllocations && m_playback_allocation_guard && was_bound && allocations > 0 && &tdata != m_editor_timeline_data)
+    {
+        LogError("Playback of a bound timeline made " + std::to_string(allocations) + " heap allocations");
+        assert(false && "playback of a bound timeline allocated");
+    }
+}
+
+void Tanim::SetTaskDispatcher(TaskDispatcher task_dispatcher) { m_task_dispatcher = std::move(task_dispatcher); }
+
+void Tanim::Dispatch(int task_count, const std::function<void(int task_idx)>& task)
+{
+    if constexpr (kTrackAllocations)
+    {
+        // the dispatching thread's allocations, its own tasks' included, are counted by the update's AllocationScope
+        const std::thread::id dispatching_thread = std::this_thread::get_id();
+        const std::function<void(int)> counted_task = [&task, &dispatching_thread](int task_idx)
+        {
+            if (std::this_thread::get_id() == dispatching_thread)
+            {
+                task(task_idx);
+                return;
+            }
+            const AllocationScope allocations{};
+            task(task_idx);
+            m_task_allocations.fetch_add(allocations.GetCount(), std::memory_order_relaxed);
+        };
+        DispatchTasks(task_count, counted_task);
+    }
+    else
+    {
+        DispatchTasks(task_count, task);
+    }
+}
+
+void Tanim::DispatchTasks(int task_count, const std::function<void(int task_idx)>& task)
+{
+    if (m_task_dispatcher)
+    {
+        m_task_dispatcher(task_count, task);
+        return;
+    }
+
+    if (!m_thread_pool)
+    {
+        m_thread_pool = std::make_unique<ThreadPool>();
+    }
+    m_thread_pool->Run(task_count, task);
+}
+
+bool Tanim::UpdateTimelinesImpl(entt::registry& registry,
+                                TimelineData& tdata,
+                                std::span<ComponentData> instances,
+                                float delta_time,
+                                bool snap_to_frames,
+                                bool parallel)
+{
+    // === Tick ===
+    bool was_bound = true;
+    m_batch_entries.clear();
+    for (int instance_idx = 0; instance_idx < static_cast<int>(instances.size()); ++instance_idx)
+    {
+        ComponentData& cdata = instances[instance_idx];
+        if (!Timeline::GetPlayerPlaying(cdata)) continue;
+
+        BatchEntry& entry = m_batch_entries.emplace_back();
+        entry.m_instance_idx = instance_idx;
+        entry.m_passed_last_frame = Timeline::TickTime(tdata, cdata, delta_time);
+        entry.m_player_frame = Timeline::GetPlayerFrame(tdata, cdata);
+        entry.m_sample_time = snap_to_frames ? static_cast<float>(entry.m_player_frame) : Timeline::GetSampleTime(tdata, cdata);
+
+        if (!Timeline::IsBound(tdata, cdata))
+        {
+            was_bound = false;
+            BindTimeline(cdata.m_cached_entities_data, tdata, cdata);
+        }
+    }
+
+    // sorted by time, so instances at the same time are adjacent and the playback cursors only move forward
+    std::sort(m_batch_entries.begin(),
+              m_batch_entries.end(),
+              [](const BatchEntry& a, const BatchEntry& b) { return a.m_sample_time < b.m_sample_time; });
+
+    // one group per distinct sample time, as [begin, end) ranges of m_batch_entries
+    m_batch_groups.clear();
+    for (int entry_idx = 0; entry_idx < static_cast<int>(m_batch_entries.size()); ++entry_idx)
+    {
+        if (m_batch_groups.empty() ||
+            m_batch_entries.at(entry_idx).m_sample_time != m_batch_entries.at(m_batch_groups.back().first).m_sample_time)
+        {
+            m_batch_groups.emplace_back(entry_idx, entry_idx);
+        }
+        m_batch_groups.back().second = entry_idx + 1;
+    }
+
+    // === Evaluate: reads the timeline only ===
+    const int seq_count = Timeline::GetSequenceCount(tdata);
+    const int evaluation_count = static_cast<int>(m_batch_groups.size()) * seq_count;
+    m_batch_values.resize(evaluation_count);
+    m_batch_holds.resize(evaluation_count);
+
+    auto is_sampled = [&tdata](int seq_idx, int player_frame)
+    {
+        const Sequence& seq = tdata.m_sequences.at(seq_idx);
+        return !seq.IsRecording() && seq.IsBetweenFirstAndLastFrame(player_frame);
+    };
+
+    // once every static sequence of an instance is written, only the dynamic ones are left to sample
+    const bool skip_held = SkipsHeldSequences(tdata);
+    const bool statics = skip_held && Timeline::AreStaticsBaked(tdata);
+    for (const BatchEntry& entry : m_batch_entries) SyncStaticHolds(statics, instances[entry.m_instance_idx]);
+    auto for_each_sequence = [&](const ComponentData& cdata, auto&& func)
+    {
+        if (statics && cdata.m_statics_applied)
+        {
+            for (const int seq_idx : tdata.m_dynamic_sequences) func(seq_idx);
+        }
+        else
+        {
+            for (int seq_idx = 0; seq_idx < seq_count; ++seq_idx) func(seq_idx);
+        }
+    };
+
+    // a group's sequence is only evaluated if one of its instances does not hold its last written value
+    m_batch_needed.assign(evaluation_count, skip_held ? 0 : 1);
+    if (skip_held)
+    {
+        for (int group_idx = 0; group_idx < static_cast<int>(m_batch_groups.size()); ++group_idx)
+        {
+            const auto [group_begin, group_end] = m_batch_groups.at(group_idx);
+            const float sample_time = m_batch_entries.at(group_begin).m_sample_time;
+            for (int entry_idx = group_begin; entry_idx < group_end; ++entry_idx)
+            {
+                const ComponentData& cdata = instances[m_batch_entries.at(entry_idx).m_instance_idx];
+                for_each_sequence(cdata,
+                                  [&](int seq_idx)
+                                  {
+                                      m_batch_needed.at(group_idx * seq_count + seq_idx) |=
+                                          !IsHeld(tdata.m_sequences.at(seq_idx), cdata, seq_idx, sample_time);
+                                  });
+            }
+        }
+    }
+
+    auto evaluate = [&](int evaluation_idx, bool thread_safe)
+    {
+        const BatchEntry& first = m_batch_entries.at(m_batch_groups.at(evaluation_idx / seq_count).first);
+        const int seq_idx = evaluation_idx % seq_count;
+        if (m_batch_needed.at(evaluation_idx) && is_sampled(seq_idx, first.m_player_frame))
+        {
+            Sequence& seq = tdata.m_sequences.at(seq_idx);
+            m_batch_values.at(evaluation_idx) = thread_safe ? reflection::EvaluateSequenceThreadSafe(seq, first.m_sample_time)
+                                                            : reflection::EvaluateSequence(seq, first.m_sample_time);
+            m_batch_holds.at(evaluation_idx) = skip_held ? FindWriteHold(seq, statics, first.m_sample_time) : HoldSpan{};
+        }
+    };
+
+    {
+        TANIM_PROFILE_SCOPE(ProfileScope::SAMPLE);
+        if (parallel)
+        {
+            const int task_count = (evaluation_count + m_evaluations_per_task - 1) / m_evaluations_per_task;
+            Dispatch(task_count,
+                     [&](int task_idx)
+                     {
+                         const int begin = task_idx * m_evaluations_per_task;
+                         const int end = std::min(begin + m_evaluations_per_task, evaluation_count);
+                         for (int evaluation_idx = begin; evaluation_idx < end; ++evaluation_idx)
+                         {
+                             evaluate(evaluation_idx, true);
+                         }
+                     });
+        }
+        else
+        {
+            for (int evaluation_idx = 0; evaluation_idx < evaluation_count; ++evaluation_idx)
+            {
+                evaluate(evaluation_idx, false);
+            }
+        }
+    }
+
+    // === Write: the only phase that touches the registry, always on the calling thread ===
+    for (int group_idx = 0; group_idx < static_cast<int>(m_batch_groups.size()); ++group_idx)
+    {
+        const auto [group_begin, group_end] = m_batch_groups.at(group_idx);
+        const int player_frame = m_batch_entries.at(group_begin).m_player_frame;
+        const float sample_time = m_batch_entries.at(group_begin).m_sample_time;
+
+        for (int entry_idx = group_begin; entry_idx < group_end; ++entry_idx)
+        {
+            ComponentData& cdata = instances[m_batch_entries.at(entry_idx).m_instance_idx];
+            const bool statics_applied = cdata.m_statics_applied;
+            for_each_sequence(cdata,
+                              [&](int seq_idx)
+                              {
+                                  if (!is_sampled(seq_idx, player_frame)) return;
+
+                                  const Sequence& seq = tdata.m_sequences.at(seq_idx);
+                                  const FieldWriter write = cdata.m_cached_writers.at(seq_idx);
+                                  const entt::entity entity = cdata.m_cached_entities.at(seq_idx);
+                                  const bool held = skip_held && IsHeld(seq, cdata, seq_idx, sample_time);
+                                  if (held) TANIM_PROFILE_COUNT(ProfileCounter::WRITES_SKIPPED, 1);
+                                  if (write && entity != entt::null && !held)
+                                  {
+                                      write(registry,
+                                            entity,
+                                            seq.m_representation_meta,
+                                            m_batch_values.at(group_idx * seq_count + seq_idx));
+                                      SetHold(seq, cdata, seq_idx, m_batch_holds.at(group_idx * seq_count + seq_idx));
+                                  }
+                              });
+            if (statics && !statics_applied) UpdateStaticsApplied(tdata, cdata);
+        }
+    }
+
+    // === Loop ===
+    for (const BatchEntry& entry : m_batch_entries)
+    {
+        Timeline::CheckLooping(tdata, instances[entry.m_instance_idx], entry.m_passed_last_frame);
+    }
+
+    return was_bound;
 }
 
 void Tanim::StopTimeline(ComponentData& cdata) { Timeline::Stop(cdata); }
@@ -186,6 +575,7 @@ void Tanim::Draw()
         ImGui::DockBuilderDockWindow("controls", dock_center_top);
         ImGui::DockBuilderDockWindow("timeliner", dock_center_bottom);
         ImGui::DockBuilderDockWindow("Player", dock_left_top);
+        ImGui::DockBuilderDockWindow("Profiler", dock_left_top);
         ImGui::DockBuilderDockWindow("curves", dock_left_bottom);
         ImGui::DockBuilderDockWindow("timeline", dock_right_top);
         ImGui::DockBuilderDockWindow("expanded sequence", dock_right_bottom);
@@ -518,6 +908,7 @@ void Tanim::Draw()
         if (ImGui::InputText("uid", uid_buf, sizeof(uid_buf)))
         {
             seq.m_seq_id.SetUid(std::string(uid_buf));
+            Timeline::InvalidateBindings(tdata);
         }
 
         ImGui::Text("display:         %s", seq.m_seq_id.GetEntityData().m_display.c_str());
@@ -594,6 +985,18 @@ void Tanim::Draw()
 
     ImGui::End();
 
+#pragma endregion
+
+    //*****************************************************
+
+#pragma region profiler
+
+    ImGui::Begin("Profiler", nullptr, ImGuiWindowFlags_NoMove);
+
+    Profiler::Draw();
+
+    ImGui::End();
+
 #pragma endregion
 
     //*****************************************************
@@ -697,6 +1100,8 @@ std::string Tanim::Serialize(TimelineData& tdata)
 
 void Tanim::Deserialize(TimelineData& data, const std::string& serialized_string)
 {
+    TANIM_PROFILE_SCOPE(ProfileScope::DESERIALIZE);
+
     assert(!serialized_string.empty());
     const nlohmann::ordered_json json = nlohmann::ordered_json::parse(serialized_string);
     assert(!json.empty());
@@ -782,10 +1187,13 @@ void Tanim::Deserialize(TimelineData& data, const std::string& serialized_string
                 deserialize_handle(kf_js.at("m_in"), kf.m_in);
                 deserialize_handle(kf_js.at("m_out"), kf.m_out);
             }
+
+            CompileCurve(curve);
         }
     }
 
     Timeline::RefreshTimelineLastFrame(data);
+    Timeline::InvalidateBindings(data);
 }
 
 }  // namespace tanim
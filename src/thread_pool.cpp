@@ -0,0 +1,103 @@
+#include "tanim/include/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace tanim
+{
+
+ThreadPool::ThreadPool(int worker_count)
+{
+    if (worker_count < 0)
+    {
+        worker_count = std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+
+    m_workers.reserve(worker_count);
+    for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx)
+    {
+        m_workers.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake_workers.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::Run(int task_count, const std::function<void(int task_idx)>& task)
+{
+    if (task_count <= 0) return;
+
+    if (m_workers.empty() || task_count == 1)
+    {
+        for (int task_idx = 0; task_idx < task_count; ++task_idx) task(task_idx);
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_task = &task;
+        m_task_count = task_count;
+        m_next_task = 0;
+        m_finished_tasks = 0;
+        ++m_generation;
+    }
+    m_wake_workers.notify_all();
+
+    RunTasks(task, task_count);
+
+    // workers that are still inside RunTasks hold a pointer to task, so wait for them too
+    std::unique_lock lock(m_mutex);
+    m_tasks_done.wait(lock, [this, task_count] { return m_finished_tasks == task_count && m_busy_workers == 0; });
+    m_task = nullptr;
+}
+
+void ThreadPool::WorkerLoop()
+{
+    int seen_generation = 0;
+    while (true)
+    {
+        const std::function<void(int)>* task = nullptr;
+        int task_count = 0;
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake_workers.wait(lock, [this, seen_generation] { return m_quit || m_generation != seen_generation; });
+            if (m_quit) return;
+
+            seen_generation = m_generation;
+            if (m_task == nullptr) continue;  // woke up after the batch was already finished
+
+            task = m_task;
+            task_count = m_task_count;
+            ++m_busy_workers;
+        }
+
+        RunTasks(*task, task_count);
+
+        {
+            std::lock_guard lock(m_mutex);
+            --m_busy_workers;
+        }
+        m_tasks_done.notify_all();
+    }
+}
+
+void ThreadPool::RunTasks(const std::function<void(int)>& task, int task_count)
+{
+    for (int task_idx = m_next_task.fetch_add(1); task_idx < task_count; task_idx = m_next_task.fetch_add(1))
+    {
+        task(task_idx);
+        m_finished_tasks.fetch_add(1);
+    }
+}
+
+}  // namespace tanim
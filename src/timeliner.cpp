@@ -60,6 +60,8 @@ bool Timeliner(TimelineData& data,
                int* first_frame,
                int timeliner_flags)
 {
+    TANIM_PROFILE_SCOPE(ProfileScope::TIMELINER);
+
     bool ret = false;
     ImGuiIO& io = ImGui::GetIO();
     int cx = static_cast<int>(io.MousePos.x);
@@ -0,0 +1,245 @@
+// checks that every function of bezier_batch.hpp returns bit-identical results to its scalar counterpart in bezier.hpp,
+// for all three batch shapes, batch sizes that do and don't fill the SIMD lanes, degenerate segments and whole curves.
+// built and registered with CTest by CMakeLists.txt. prints every mismatch and returns 1 if there was one.
+
+#include "tanim/include/bezier.hpp"
+#include "tanim/include/bezier_batch.hpp"
+#include "tanim/include/curve_functions.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace tanim;
+
+namespace
+{
+
+int g_checks = 0;
+int g_mismatches = 0;
+
+// bitwise, so -0.0f and 0.0f differ. two NaNs count as equal, whatever their payload
+void Expect(float batch, float scalar, const std::string& what, size_t index)
+{
+    g_checks++;
+    if (std::bit_cast<uint32_t>(batch) == std::bit_cast<uint32_t>(scalar)) return;
+    if (std::isnan(batch) && std::isnan(scalar)) return;
+
+    g_mismatches++;
+    if (g_mismatches <= 20)
+    {
+        std::cerr.precision(9);
+        std::cerr << what << " [" << index << "]: batch " << batch << ", scalar " << scalar << '\n';
+    }
+}
+
+std::vector<float> RandomFloats(size_t count, float min, float max, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> dist(min, max);
+    std::vector<float> values(count);
+    for (float& value : values) value = dist(rng);
+    return values;
+}
+
+// control points of size segments with ascending x (p0x <= p1x, p2x <= p3x), like CompileCurve produces.
+// every fourth segment is degenerate: all four x equal, or the handles sitting on the ends
+struct Segments
+{
+    std::vector<float> m_p0, m_p1, m_p2, m_p3;
+};
+
+Segments RandomSegments(size_t count, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    Segments segments{};
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        const float start = unit(rng) * 10.0f;
+        const float length = unit(rng) * 5.0f + 0.01f;
+        float p1 = start + unit(rng) * length;
+        float p2 = start + unit(rng) * length;
+        float p3 = start + length;
+        if (idx % 4 == 3)
+        {
+            if (idx % 8 == 3) p1 = p2 = p3 = start;
+            else
+            {
+                p1 = start;
+                p2 = p3;
+            }
+        }
+        segments.m_p0.push_back(start);
+        segments.m_p1.push_back(p1);
+        segments.m_p2.push_back(p2);
+        segments.m_p3.push_back(p3);
+    }
+    return segments;
+}
+
+// === Polynomials ===
+
+void CheckPolynomials(size_t count, std::mt19937& rng)
+{
+    const Segments seg = RandomSegments(count, rng);
+    const std::vector<float> t = RandomFloats(count, 0.0f, 1.0f, rng);
+    const float one_t = t.empty() ? 0.5f : t.front();
+    std::vector<float> out(count);
+
+    CubicBezierBatch(seg.m_p0, seg.m_p1, seg.m_p2, seg.m_p3, t, out);
+    for (size_t i = 0; i < count; ++i)
+        Expect(out[i], CubicBezierX(seg.m_p0[i], seg.m_p1[i], seg.m_p2[i], seg.m_p3[i], t[i]), "CubicBezierBatch per lane", i);
+
+    CubicBezierBatch(seg.m_p0, seg.m_p1, seg.m_p2, seg.m_p3, one_t, out);
+    for (size_t i = 0; i < count; ++i)
+        Expect(out[i], CubicBezierY(seg.m_p0[i], seg.m_p1[i], seg.m_p2[i], seg.m_p3[i], one_t), "CubicBezierBatch one t", i);
+
+    CubicBezierBatch(-0.3f, 1.7f, 0.2f, 2.5f, t, out);
+    for (size_t i = 0; i < count; ++i) Expect(out[i], CubicBezierX(-0.3f, 1.7f, 0.2f, 2.5f, t[i]), "CubicBezierBatch one curve", i);
+
+    CubicBezierDxDtBatch(seg.m_p0, seg.m_p1, seg.m_p2, seg.m_p3, t, out);
+    for (size_t i = 0; i < count; ++i)
+        Expect(out[i], CubicBezierDxDt(seg.m_p0[i], seg.m_p1[i], seg.m_p2[i], seg.m_p3[i], t[i]), "CubicBezierDxDtBatch per lane", i);
+
+    CubicBezierDxDtBatch(seg.m_p0, seg.m_p1, seg.m_p2, seg.m_p3, one_t, out);
+    for (size_t i = 0; i < count; ++i)
+        Expect(out[i], CubicBezierDxDt(seg.m_p0[i], seg.m_p1[i], seg.m_p2[i], seg.m_p3[i], one_t), "CubicBezierDxDtBatch one t", i);
+
+    CubicBezierDxDtBatch(-0.3f, 1.7f, 0.2f, 2.5f, t, out);
+    for (size_t i = 0; i < count; ++i)
+        Expect(out[i], CubicBezierDxDt(-0.3f, 1.7f, 0.2f, 2.5f, t[i]), "CubicBezierDxDtBatch one curve", i);
+}
+
+// === FindTForX ===
+
+void CheckFindTForX(size_t count, std::mt19937& rng)
+{
+    const Segments seg = RandomSegments(count, rng);
+    std::vector<float> target(count);
+    std::uniform_real_distribution<float> unit(-0.1f, 1.1f);  // a little outside the segments too
+    for (size_t i = 0; i < count; ++i) target[i] = seg.m_p0[i] + (seg.m_p3[i] - seg.m_p0[i]) * unit(rng);
+    const float one_target = count == 0 ? 5.0f : target.front();
+    std::vector<float> out(count);
+
+    FindTForXBatch(seg.m_p0, seg.m_p1, seg.m_p2, seg.m_p3, target, out);
+    for (size_t i = 0; i < count; ++i)
+        Expect(out[i], FindTForX(seg.m_p0[i], seg.m_p1[i], seg.m_p2[i], seg.m_p3[i], target[i]), "FindTForXBatch per lane", i);
+
+    FindTForXBatch(seg.m_p0, seg.m_p1, seg.m_p2, seg.m_p3, one_target, out);
+    for (size_t i = 0; i < count; ++i)
+        Expect(out[i], FindTForX(seg.m_p0[i], seg.m_p1[i], seg.m_p2[i], seg.m_p3[i], one_target), "FindTForXBatch one x", i);
+
+    // one curve: a regular segment, and one whose handles stop at its start (slow Newton convergence near 0)
+    const float curves[2][4] = {{1.0f, 1.4f, 2.2f, 3.0f}, {1.0f, 1.0f, 1.0f, 3.0f}};
+    for (const auto& c : curves)
+    {
+        std::vector<float> xs = RandomFloats(count, 0.9f, 3.1f, rng);
+        FindTForXBatch(c[0], c[1], c[2], c[3], xs, out);
+        for (size_t i = 0; i < count; ++i) Expect(out[i], FindTForX(c[0], c[1], c[2], c[3], xs[i]), "FindTForXBatch one curve", i);
+    }
+}
+
+// === SampleRuntimeCurveBatch ===
+
+Curve MakeCurve(int count, CurveHandleType handle_type, TimeSolver solver, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> gap(0.2f, 3.0f);
+    std::vector<std::pair<float, float>> keys{};
+    float time = 0.0f;
+    for (int k = 0; k < count; ++k)
+    {
+        // repeated values make level segments for FLAT and AUTO
+        const float v = k % 3 == 2 ? keys.back().second : value(rng);
+        keys.emplace_back(time, v);
+        time += gap(rng);
+    }
+
+    Curve curve{};
+    curve.m_time_solver = solver;
+    SetCurveHandleType(curve, handle_type);
+    LockCurveHandleType(curve);
+    AddKeyframes(curve, keys);
+    CompileCurve(curve);
+    return curve;
+}
+
+void CheckCurve(const Curve& curve, const std::string& name, std::mt19937& rng)
+{
+    const RuntimeCurveView runtime = curve.m_runtime;
+    const float first = runtime.m_times.front();
+    const float last = runtime.m_times.back();
+
+    std::vector<float> ascending{};
+    for (float time = first - 1.0f; time < last + 1.0f; time += 0.0173f) ascending.push_back(time);
+    for (float key_time : runtime.m_times) ascending.push_back(key_time);  // exactly on keyframes, out of order at the end
+
+    const std::vector<std::pair<std::string, std::vector<float>>> time_sets = {
+        {"ascending", ascending},
+        {"random", RandomFloats(257, first - 2.0f, last + 2.0f, rng)},
+        {"short", RandomFloats(3, first, last, rng)},
+        {"empty", {}},
+    };
+    for (const auto& [set_name, times] : time_sets)
+    {
+        std::vector<float> out(times.size());
+        SampleRuntimeCurveBatch(runtime, times, out);
+        for (size_t i = 0; i < times.size(); ++i)
+            Expect(out[i], SampleRuntimeCurve(runtime, times[i]), "SampleRuntimeCurveBatch " + name + " " + set_name, i);
+    }
+}
+
+void CheckCurves(std::mt19937& rng)
+{
+    const std::pair<CurveHandleType, const char*> handle_types[] = {
+        {CurveHandleType::UNCONSTRAINED, "UNCONSTRAINED"},
+        {CurveHandleType::AUTO, "AUTO"},
+        {CurveHandleType::FLAT, "FLAT"},
+        {CurveHandleType::LINEAR, "LINEAR"},
+        {CurveHandleType::CONSTANT, "CONSTANT"},
+    };
+    const std::pair<TimeSolver, const char*> solvers[] = {{TimeSolver::NEWTON, "NEWTON"}, {TimeSolver::ANALYTIC, "ANALYTIC"}};
+
+    for (const auto& [handle_type, handle_name] : handle_types)
+    {
+        for (const auto& [solver, solver_name] : solvers)
+        {
+            for (int count : {1, 2, 5, 40})
+            {
+                const Curve curve = MakeCurve(count, handle_type, solver, rng);
+                CheckCurve(curve, std::string(handle_name) + " " + solver_name + " " + std::to_string(count) + " keys", rng);
+            }
+        }
+    }
+
+    // no keyframes at all
+    std::vector<float> out(5);
+    const std::vector<float> times = {-1.0f, 0.0f, 0.5f, 1.0f, 10.0f};
+    SampleRuntimeCurveBatch(RuntimeCurveView{}, times, out);
+    for (size_t i = 0; i < times.size(); ++i) Expect(out[i], SampleRuntimeCurve(RuntimeCurveView{}, times[i]), "SampleRuntimeCurveBatch empty curve", i);
+}
+
+}  // namespace
+
+int main()
+{
+    std::mt19937 rng(1234);
+
+    // every remainder of the 4 and 8 lane widths, plus a few full runs
+    for (size_t count = 0; count <= 37; ++count)
+    {
+        CheckPolynomials(count, rng);
+        CheckFindTForX(count, rng);
+    }
+    CheckPolynomials(1000, rng);
+    CheckFindTForX(1000, rng);
+    CheckCurves(rng);
+
+    std::cout << "bezier batch width " << GetBezierBatchWidth() << ": " << g_checks << " checks, " << g_mismatches
+              << " mismatches\n";
+    return g_mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+// checks that playback of a bound timeline makes no heap allocation: UpdateTimeline, UpdateTimelineParallel,
+// UpdateTimelines, UpdateTimelinesParallel and UpdateMappedTimeline, with and without skipping held sequences.
+// built by CMakeLists.txt with TANIM_TRACK_ALLOCATIONS and registered with CTest. prints every update that allocated
+// and returns 1 if there was one.
+
+#include "tanim/include/alloc_tracking.hpp"
+#include "tanim/include/curve_functions.hpp"
+#include "tanim/include/registry.hpp"
+#include "tanim/include/sequence.hpp"
+#include "tanim/include/tanim.hpp"
+#include "tanim/include/thread_pool.hpp"
+#include "tanim/include/user_override.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// every field type playback writes
+struct AllocationCheckComponent
+{
+    float m_float{0.0f};
+    int m_int{0};
+    bool m_bool{false};
+    glm::vec2 m_vec2{};
+    glm::vec3 m_vec3{};
+    glm::vec4 m_vec4{};
+    glm::quat m_quat{1.0f, 0.0f, 0.0f, 0.0f};
+};
+
+VISITABLE_STRUCT(AllocationCheckComponent, m_float, m_int, m_bool, m_vec2, m_vec3, m_vec4, m_quat);
+
+namespace
+{
+
+entt::registry g_registry{};
+std::map<std::string, entt::entity> g_entities{};
+
+int g_failures = 0;
+
+}  // namespace
+
+std::optional<entt::entity> tanim::FindEntityOfUID(const ComponentData&, const std::string& uid_to_find)
+{
+    const auto it = g_entities.find(uid_to_find);
+    if (it == g_entities.end()) return std::nullopt;
+    return it->second;
+}
+
+void tanim::LogError(const std::string& message) { std::cerr << "error: " << message << '\n'; }
+
+void tanim::LogInfo(const std::string& message) { std::cout << message << '\n'; }
+
+using namespace tanim;
+
+namespace
+{
+
+// every field of every entity. every third sequence keeps the two equal keyframes of AddSequence and is static,
+// the others get random keyframes, some with CONSTANT handles so their values hold between keyframes
+TimelineData MakeTimeline(const std::vector<EntityData>& entity_datas)
+{
+    const RegisteredComponent& component = GetRegistry().GetComponents().at(0);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+    TimelineData tdata{};
+    tdata.m_last_frame = 60;
+    tdata.m_playback_type = PlaybackType::LOOP;
+
+    int seq_idx = 0;
+    for (const EntityData& entity_data : entity_datas)
+    {
+        for (const std::string& field_name : component.m_field_names)
+        {
+            SequenceId seq_id(entity_data, component.m_struct_name, field_name);
+            reflection::AddSequence(g_registry.get<AllocationCheckComponent>(g_entities.at(entity_data.m_uid)), tdata, seq_id);
+            Sequence& seq = tdata.m_sequences.back();
+            if (seq_idx++ % 3 == 0) continue;
+
+            std::vector<SequenceKeyframe> keys(5);
+            for (int k = 0; k < 5; ++k)
+            {
+                keys.at(k).m_frame = static_cast<float>(k * 15);
+                for (float& curve_value : keys.at(k).m_value) curve_value = value(rng);
+                if (seq.m_representation_meta == RepresentationMeta::QUAT)
+                {
+                    const SampledValue& v = keys.at(k).m_value;
+                    const glm::quat q = glm::normalize(glm::quat(v[0], v[1], v[2], v[3]));
+                    keys.at(k).m_value = {q.w, q.x, q.y, q.z};
+                }
+            }
+            for (int curve_idx = 0; curve_idx < seq.GetCurveCount(); ++curve_idx)
+            {
+                Curve& curve = seq.m_curves.at(curve_idx);
+                const bool spins = seq.m_representation_meta == RepresentationMeta::QUAT && curve_idx == 4;
+                curve.m_keyframes.front().m_pos.y = spins ? 0.0f : keys.front().m_value.at(curve_idx);
+                curve.m_keyframes.back().m_pos.y = spins ? 0.0f : keys.back().m_value.at(curve_idx);
+                if (seq_idx % 4 == 0 && !curve.m_handle_type_locked) SetCurveHandleType(curve, CurveHandleType::CONSTANT);
+            }
+            seq.AddKeyframes(std::span<const SequenceKeyframe>(keys));
+            for (Curve& curve : seq.m_curves)
+            {
+                ApplyCurveHandleTypeOnCurve(curve);
+                ResolveCurveHandles(curve);
+            }
+        }
+    }
+    Tanim::BakeStaticSequences(tdata);
+    return tdata;
+}
+
+// runs update for kWarmupTicks, so every instance is bound and has written its statics, then for kTicks more,
+// each of which must not allocate. the delta times vary, so some ticks stay inside held values and some don't
+template <typename Update>
+void Check(const std::string& name, Update&& update)
+{
+    constexpr int kWarmupTicks = 90;
+    constexpr int kTicks = 300;
+
+    for (int tick = 0; tick < kWarmupTicks; ++tick) update(1.0f / 60.0f);
+
+    int allocating_ticks = 0;
+    for (int tick = 0; tick < kTicks; ++tick)
+    {
+        const float delta_time = tick % 7 == 0 ? 0.05f : 1.0f / 60.0f;
+        const AllocationScope allocations{};
+        update(delta_time);
+        const int64_t count = std::max(allocations.GetCount(), Tanim::GetLastUpdateAllocations());
+        if (count == 0) continue;
+
+        if (allocating_ticks++ < 5) std::cerr << name << ": tick " << tick << " made " << count << " allocations\n";
+    }
+
+    if (allocating_ticks > 0) g_failures++;
+    std::cout << name << ": " << allocating_ticks << " of " << kTicks << " ticks allocated\n";
+}
+
+}  // namespace
+
+int main()
+{
+    if (!kTrackAllocations)
+    {
+        std::cerr << "build with TANIM_TRACK_ALLOCATIONS\n";
+        return 1;
+    }
+
+    // the counter itself: one allocation on another thread is counted there, and only there
+    int64_t other_thread_count = 0;
+    std::thread other_thread(
+        [&other_thread_count]
+        {
+            const AllocationScope allocations{};
+            int* volatile allocated = new int(1);  // volatile, so the compiler can't elide the new / delete pair
+            delete allocated;
+            other_thread_count = allocations.GetCount();
+        });
+    const AllocationScope this_thread{};
+    other_thread.join();
+    if (other_thread_count != 1 || this_thread.GetCount() != 0)
+    {
+        std::cerr << "allocations are not counted per thread\n";
+        return 1;
+    }
+
+    GetRegistry().RegisterComponent<AllocationCheckComponent>();
+
+    std::vector<EntityData> entity_datas{};
+    for (int e = 0; e < 4; ++e)
+    {
+        const std::string uid = "entity_" + std::to_string(e);
+        entity_datas.push_back({uid, uid});
+        g_entities[uid] = g_registry.create();
+        g_registry.emplace<AllocationCheckComponent>(g_entities.at(uid));
+    }
+    TimelineData tdata = MakeTimeline(entity_datas);
+
+    // enough workers that the parallel updates run tasks on other threads than this one
+    ThreadPool pool(3);
+    Tanim::SetTaskDispatcher([&pool](int task_count, const std::function<void(int)>& task) { pool.Run(task_count, task); });
+
+    QuantizeSettings quantize{};
+    quantize.m_enabled = true;
+    const std::vector<uint8_t> baked = Tanim::SerializeBaked(tdata, quantize);
+
+    for (const bool skip_held : {true, false})
+    {
+        Tanim::SetSkipHeldSequences(skip_held);
+        const std::string suffix = skip_held ? "" : " (no held skipping)";
+
+        ComponentData single{};
+        Tanim::StartTimeline(tdata, single);
+        Check("UpdateTimeline" + suffix,
+              [&](float delta_time) { Tanim::UpdateTimeline(g_registry, entity_datas, tdata, single, delta_time); });
+
+        ComponentData single_parallel{};
+        Tanim::StartTimeline(tdata, single_parallel);
+        Check("UpdateTimelineParallel" + suffix,
+              [&](float delta_time)
+              { Tanim::UpdateTimelineParallel(g_registry, entity_datas, tdata, single_parallel, delta_time); });
+
+        // instances at different times, so there are several sample groups
+        std::vector<ComponentData> instances(6);
+        std::vector<ComponentData> parallel_instances(6);
+        for (int instance_idx = 0; instance_idx < 6; ++instance_idx)
+        {
+            for (ComponentData* cdata : {&instances.at(instance_idx), &parallel_instances.at(instance_idx)})
+            {
+                Tanim::BindTimeline(entity_datas, tdata, *cdata);
+                Tanim::StartTimeline(tdata, *cdata);
+                cdata->m_player_time = static_cast<float>(instance_idx) * 0.13f;
+            }
+        }
+        Check("UpdateTimelines" + suffix,
+              [&](float delta_time) { Tanim::UpdateTimelines(g_registry, tdata, instances, delta_time); });
+        Check("UpdateTimelinesParallel" + suffix,
+              [&](float delta_time) { Tanim::UpdateTimelinesParallel(g_registry, tdata, parallel_instances, delta_time); });
+
+        MappedTimeline mapped{};
+        if (!mapped.View(baked))
+        {
+            std::cerr << "couldn't view the baked timeline\n";
+            return 1;
+        }
+        ComponentData mapped_cdata{};
+        mapped_cdata.m_cached_entities_data = entity_datas;
+        Tanim::StartTimeline(mapped.GetTimelineData(), mapped_cdata);
+        Check("UpdateMappedTimeline" + suffix,
+              [&](float delta_time) { Tanim::UpdateMappedTimeline(g_registry, mapped, mapped_cdata, delta_time); });
+    }
+
+    Tanim::SetTaskDispatcher({});
+    return g_failures == 0 ? 0 : 1;
+}